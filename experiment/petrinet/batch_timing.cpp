@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "linear.hpp"
+#include "petrinet.hpp"
+#include "splinear.hpp"
+#include "timer.hpp"
+
+using namespace sanity::petrinet;
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+// K parameter points of the same model, solved one by one and as a batch
+static void compareBatchSor(const ReducedReachGenResult& rg, uint K,
+                            uint nIter)
+{
+    uint n = rg.graph.nodeCount();
+    std::cout << "# of states: " << n << ", lanes: " << K << std::endl;
+    std::vector<std::vector<Real>> lane_rates;
+    for (uint lane = 0; lane < K; lane++)
+    {
+        auto rates = rg.edgeRates;
+        for (auto& r : rates)
+        {
+            r *= 1.0 + 0.01 * lane;
+        }
+        lane_rates.push_back(rates);
+    }
+    auto pattern = srnRateMatrixPattern(rg.graph, rg.edgeRates);
+
+    timer t("one by one");
+    for (uint lane = 0; lane < K; lane++)
+    {
+        updateValues(pattern, lane_rates[lane]);
+        Vector prob(n, 1.0);
+        srnSteadyStateSor(pattern.matrix, mutableView(prob), 1.0, 0.0,
+                          nIter);
+    }
+    t.whatTime();
+
+    auto Q = spmatrixBatch(pattern, lane_rates);
+    Matrix prob(n, K, 1.0);
+    timer tb("batch");
+    srnSteadyStateSorBatch(Q, mutableView(prob), 1.0, 0.0, nIter);
+    tb.whatTime();
+}
+
+TEST(batch_timing, multi_stage_sor)
+{
+    uint site_count = 5;
+    uint max_job = 10;
+    SrnCreator crt;
+    crt.expTrans(1.0).oarc(0).harc(0, max_job);
+    crt.place(0);
+    for (uint i = 1; i < site_count; i++)
+    {
+        crt.expTrans(1.0).iarc(i - 1).oarc(i).harc(i, max_job);
+        crt.place(1);
+    }
+    crt.expTrans(1.0).iarc(site_count - 1);
+    auto rg = genReducedReachGraph(crt.create(), crt.marking());
+    for (uint K : {4u, 8u})
+    {
+        compareBatchSor(rg, K, 20);
+    }
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "linear.hpp"
+#include "petrinet.hpp"
+#include "splinear.hpp"
+#include "timer.hpp"
+
+using namespace sanity::petrinet;
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+TEST(iteration_timing, multi_stage)
+{
+    uint site_count = 5;
+    uint max_job = 10;
+    SrnCreator crt;
+    crt.expTrans(1.0).oarc(0).harc(0, max_job);
+    crt.place(0);
+    for (uint i = 1; i < site_count; i++)
+    {
+        crt.expTrans(1.0).iarc(i - 1).oarc(i).harc(i, max_job);
+        crt.place(1);
+    }
+    crt.expTrans(1.0).iarc(site_count - 1);
+    auto rg = genReducedReachGraph(crt.create(), crt.marking());
+    uint n = rg.graph.nodeCount();
+    std::cout << "# of states: " << n << std::endl;
+    auto Q = srnRateMatrix(rg.graph, rg.edgeRates);
+    auto P = Q;
+    Real q = 10.0;
+    for (uint i = 0; i < n; i++)
+    {
+        for (uint k = P.ptr[i]; k < P.ptr[i + 1]; k++)
+        {
+            P.val[k] = P.val[k] / q + (P.idx[k] == i ? 1.0 : 0.0);
+        }
+    }
+    uint nIter = 50;
+    for (uint check : {1u, 10u})
+    {
+        std::cout << "check interval: " << check << std::endl;
+        Vector prob(n, 1.0);
+        timer t("sor");
+        srnSteadyStateSor(Q, mutableView(prob), 1.0, 0.0, nIter, check);
+        t.whatTime();
+        Vector prob_power(n, 1.0);
+        timer tp("power");
+        srnSteadyStatePower(P, mutableView(prob_power), 0.0, nIter, check);
+        tp.whatTime();
+    }
+}
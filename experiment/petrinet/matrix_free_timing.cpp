@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "linear.hpp"
+#include "petrinet.hpp"
+#include "splinear.hpp"
+#include "timer.hpp"
+
+using namespace sanity::petrinet;
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+TEST(matrix_free_timing, multi_stage_dot)
+{
+    uint site_count = 5;
+    uint max_job = 10;
+    SrnCreator crt;
+    crt.expTrans(1.0).oarc(0).harc(0, max_job);
+    crt.place(0);
+    for (uint i = 1; i < site_count; i++)
+    {
+        crt.expTrans(1.0).iarc(i - 1).oarc(i).harc(i, max_job);
+        crt.place(1);
+    }
+    crt.expTrans(1.0).iarc(site_count - 1);
+    auto srn = crt.create();
+
+    timer tgen("explicit generation");
+    auto rg = genReducedReachGraph(srn, crt.marking());
+    auto Q = srnRateMatrix(rg.graph, rg.edgeRates);
+    tgen.whatTime();
+    timer tfree("matrix free generation");
+    SrnGenerator gen(srn, crt.marking());
+    tfree.whatTime();
+    uint n = gen.stateCount();
+    std::cout << "# of states: " << n << ", nnz: " << Q.val.size()
+              << std::endl;
+    std::size_t matrix_bytes = Q.val.size() * (sizeof(Real) + sizeof(uint)) +
+                               Q.ptr.size() * sizeof(uint);
+    std::cout << "matrix bytes: " << matrix_bytes
+              << ", marking bytes: " << gen.markingBytes() << std::endl;
+
+    uint nIter = 10;
+    Vector v(n, 1.0);
+    Vector x(n);
+    timer t("explicit dot");
+    for (uint i = 0; i < nIter; i++)
+    {
+        dot(Q, v, mutableView(x));
+    }
+    t.whatTime();
+    timer tf("matrix free dot");
+    for (uint i = 0; i < nIter; i++)
+    {
+        gen.dot(v, mutableView(x));
+    }
+    tf.whatTime();
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "graph.hpp"
+#include "linear.hpp"
+#include "petrinet.hpp"
+#include "splinear.hpp"
+#include "timer.hpp"
+
+using namespace sanity::petrinet;
+using namespace sanity::splinear;
+using namespace sanity::linear;
+using namespace sanity::graph;
+
+static uint bandwidth(const Spmatrix& A)
+{
+    uint bw = 0;
+    for (uint i = 0; i < A.nrow; i++)
+    {
+        for (uint k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+        {
+            bw = std::max(bw, A.idx[k] > i ? A.idx[k] - i : i - A.idx[k]);
+        }
+    }
+    return bw;
+}
+
+static void compareOrder(const ReducedReachGenResult& rg, uint nIter)
+{
+    std::cout << "# of states: " << rg.graph.nodeCount()
+              << ", # of edges: " << rg.graph.edgeCount() << std::endl;
+    auto Q = srnRateMatrix(rg.graph, rg.edgeRates);
+    timer trcm("rcm");
+    auto mat2node = reverseCuthillMckee(rg.graph);
+    trcm.whatTime();
+    auto Qrcm = srnRateMatrix(rg.graph, rg.edgeRates, mat2node);
+    std::cout << "bandwidth, discovery order: " << bandwidth(Q)
+              << ", rcm: " << bandwidth(Qrcm) << std::endl;
+
+    Vector v(Q.ncol, 1.0);
+    Vector x(Q.nrow);
+    timer t("discovery order spmv");
+    for (uint i = 0; i < nIter; i++)
+    {
+        dot(Q, v, mutableView(x));
+    }
+    t.whatTime();
+    timer tr("rcm spmv");
+    for (uint i = 0; i < nIter; i++)
+    {
+        dot(Qrcm, v, mutableView(x));
+    }
+    tr.whatTime();
+
+    Vector prob(Q.nrow, 1.0);
+    timer ts("discovery order sor");
+    srnSteadyStateSor(Q, mutableView(prob), 1.0, 0.0, nIter);
+    ts.whatTime();
+    Vector prob_rcm(Q.nrow, 1.0);
+    timer tsr("rcm sor");
+    srnSteadyStateSor(Qrcm, mutableView(prob_rcm), 1.0, 0.0, nIter);
+    tsr.whatTime();
+}
+
+TEST(reorder_timing, multi_stage)
+{
+    uint site_count = 5;
+    uint max_job = 12;
+    SrnCreator crt;
+    crt.expTrans(1.0).oarc(0).harc(0, max_job);
+    crt.place(0);
+    for (uint i = 1; i < site_count; i++)
+    {
+        crt.expTrans(1.0).iarc(i - 1).oarc(i).harc(i, max_job);
+        crt.place(1);
+    }
+    crt.expTrans(1.0).iarc(site_count - 1);
+    compareOrder(genReducedReachGraph(crt.create(), crt.marking()), 20);
+}
+
+TEST(reorder_timing, many_parallel)
+{
+    SrnCreator crt;
+    for (uint i = 0; i < 18; i++)
+    {
+        auto up = crt.place(1);
+        auto down = crt.place(0);
+        crt.expTrans(1.0).iarc(up).oarc(down);
+        crt.expTrans(2.0).iarc(down).oarc(up);
+    }
+    compareOrder(genReducedReachGraph(crt.create(), crt.marking()), 20);
+}
@@ -45,3 +45,184 @@ TEST(sim_timing, molloy_thesis)
         sim.end();
     }
 }
+
+TEST(sim_timing, molloy_thesis_engines)
+{
+    GpnCreator ct;
+    auto p0 = ct.place(1);
+    auto p1 = ct.place();
+    auto p2 = ct.place();
+    auto p3 = ct.place();
+    auto p4 = ct.place();
+
+    ct.expTrans(1.0).iarc(p0).oarc(p1).oarc(p2);
+    ct.expTrans(3.0).iarc(p1).oarc(p3);
+    ct.expTrans(7.0).iarc(p2).oarc(p4);
+    ct.expTrans(9.0).iarc(p3).oarc(p1);
+    ct.expTrans(5.0).iarc(p3).iarc(p4).oarc(p0);
+
+    auto gpn = ct.create();
+    auto mk = ct.marking();
+
+    Real end = 10000;
+    uint nSample = 1000;
+    for (auto engine : {GpnEngine::EventQueue, GpnEngine::DirectMethod})
+    {
+        auto sim = gpnSimulator(gpn, mk, UniformSampler(1), engine);
+        auto mk_p0 = GpnObProbReward(0, end, gpnPlaceTokenFunc(p0));
+        auto evt_counter = GpnObEventCounter();
+        sim.addObserver(mk_p0);
+        sim.addObserver(evt_counter);
+        timer t(engine == GpnEngine::EventQueue ? "event queue"
+                                                : "direct method");
+        for (uint i = 0; i < nSample; i++)
+        {
+            sim.begin();
+            sim.runFor(end);
+            sim.end();
+        }
+        t.whatTime();
+        std::cout << "token in p0: "
+                  << confidenceInterval(mk_p0.samples(), 0.99)
+                  << ", events per run: " << mean(evt_counter.samples())
+                  << std::endl;
+    }
+}
+
+TEST(sim_timing, tau_leap_cyclic)
+{
+    // three stations in a cycle sharing 30000 tokens
+    GpnCreator ct;
+    auto p0 = ct.place(10000);
+    auto p1 = ct.place(10000);
+    auto p2 = ct.place(10000);
+    ct.expTrans(1000.0).iarc(p0).oarc(p1);
+    ct.expTrans(1100.0).iarc(p1).oarc(p2);
+    ct.expTrans(1200.0).iarc(p2).oarc(p0);
+    auto gpn = ct.create();
+    auto mk = ct.marking();
+
+    Real end = 100;
+    uint nSample = 20;
+    auto run = [&](GpnSimulator& sim, const char* name) {
+        auto mk_p0 = GpnObProbReward(0, end, gpnPlaceTokenFunc(p0));
+        auto evt_counter = GpnObEventCounter();
+        sim.addObserver(mk_p0);
+        sim.addObserver(evt_counter);
+        timer t(name);
+        for (uint i = 0; i < nSample; i++)
+        {
+            sim.begin();
+            sim.runFor(end);
+            sim.end();
+        }
+        t.whatTime();
+        std::cout << "token in p0: "
+                  << confidenceInterval(mk_p0.samples(), 0.99)
+                  << ", events per run: " << mean(evt_counter.samples())
+                  << std::endl;
+    };
+    auto exact = gpnSimulator(gpn, mk, UniformSampler(1));
+    run(exact, "direct method");
+    auto leap = gpnTauLeapSimulator(gpn, mk, UniformSampler(1));
+    run(leap, "tau leaping");
+    const auto& stats = leap.state().tauLeap.stats;
+    std::cout << "leaps: " << stats.leaps
+              << ", leap firings: " << stats.leapFirings
+              << ", exact steps: " << stats.exactSteps
+              << ", rejections: " << stats.rejections << ", tau in ["
+              << stats.minTau << ", " << stats.maxTau << "]" << std::endl;
+}
+
+TEST(sim_timing, molloy_thesis_replications)
+{
+    GpnCreator ct;
+    auto p0 = ct.place(1);
+    auto p1 = ct.place();
+    auto p2 = ct.place();
+    auto p3 = ct.place();
+    auto p4 = ct.place();
+
+    ct.expTrans(1.0).iarc(p0).oarc(p1).oarc(p2);
+    ct.expTrans(3.0).iarc(p1).oarc(p3);
+    ct.expTrans(7.0).iarc(p2).oarc(p4);
+    ct.expTrans(9.0).iarc(p3).oarc(p1);
+    ct.expTrans(5.0).iarc(p3).iarc(p4).oarc(p0);
+
+    auto gpn = ct.create();
+    auto mk = ct.marking();
+    auto sim = gpnSimulator(gpn, mk, UniformSampler());
+
+    Real start = 0;
+    Real end = 10000;
+    auto mk_p0 = GpnObProbReward(start, end, gpnPlaceTokenFunc(p0));
+    auto mk_p3 = GpnObProbReward(start, end, gpnPlaceTokenFunc(p3));
+    auto evt_counter = GpnObEventCounter();
+
+    uint nSample = 1000;
+    for (uint nthread : {1u, 2u, 4u, 8u})
+    {
+        auto name = std::to_string(nthread) + " threads";
+        timer t(name.c_str());
+        auto res = runReplications(sim, nSample, end, 1, nthread, gpnReseed,
+                                   mk_p0, mk_p3, evt_counter);
+        t.whatTime();
+        std::cout << "token in p0: "
+                  << confidenceInterval(std::get<0>(res).samples(), 0.99)
+                  << std::endl;
+    }
+}
+
+TEST(sim_timing, uniform_samplers)
+{
+    uint n = 100000000;
+    std::vector<Real> buf(4096);
+    {
+        UniformSampler gen(1);
+        timer t("mt19937_64");
+        Real sum = 0;
+        for (uint i = 0; i < n; i++)
+        {
+            sum += gen();
+        }
+        t.whatTime();
+        std::cout << "mean: " << sum / n << std::endl;
+    }
+    {
+        PhiloxSampler gen(1);
+        timer t("philox, one at a time");
+        Real sum = 0;
+        for (uint i = 0; i < n; i++)
+        {
+            sum += gen();
+        }
+        t.whatTime();
+        std::cout << "mean: " << sum / n << std::endl;
+    }
+    {
+        PhiloxSampler gen(1);
+        timer t("philox, fill");
+        Real sum = 0;
+        for (uint i = 0; i < n; i += buf.size())
+        {
+            gen.fill(buf);
+            for (Real u : buf)
+            {
+                sum += u;
+            }
+        }
+        t.whatTime();
+        std::cout << "mean: " << sum / n << std::endl;
+    }
+    {
+        std::function<Real()> gen = BufferedSampler(1);
+        timer t("philox, buffered through std::function");
+        Real sum = 0;
+        for (uint i = 0; i < n; i++)
+        {
+            sum += gen();
+        }
+        t.whatTime();
+        std::cout << "mean: " << sum / n << std::endl;
+    }
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "linear.hpp"
+#include "petrinet.hpp"
+#include "splinear.hpp"
+#include "timer.hpp"
+
+using namespace sanity::petrinet;
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+static Spmatrix multiStageGenerator(uint site_count, uint max_job)
+{
+    SrnCreator crt;
+    crt.expTrans(1.0).oarc(0).harc(0, max_job);
+    crt.place(0);
+    for (uint i = 1; i < site_count; i++)
+    {
+        crt.expTrans(1.0).iarc(i - 1).oarc(i).harc(i, max_job);
+        crt.place(1);
+    }
+    crt.expTrans(1.0).iarc(site_count - 1);
+    auto rg = genReducedReachGraph(crt.create(), crt.marking());
+    return srnRateMatrix(rg.graph, rg.edgeRates);
+}
+
+static Spmatrix manyParallelGenerator(uint site_count)
+{
+    SrnCreator crt;
+    for (uint i = 0; i < site_count; i++)
+    {
+        auto up = crt.place(1);
+        auto down = crt.place(0);
+        crt.expTrans(1.0).iarc(up).oarc(down);
+        crt.expTrans(2.0).iarc(down).oarc(up);
+    }
+    auto rg = genReducedReachGraph(crt.create(), crt.marking());
+    return srnRateMatrix(rg.graph, rg.edgeRates);
+}
+
+static void compareSpmv(const Spmatrix& Q, uint repeat)
+{
+    std::cout << "# of states: " << Q.nrow << ", nnz: " << Q.val.size()
+              << std::endl;
+    Vector v(Q.ncol, 1.0);
+    Vector x(Q.nrow);
+    timer t("csr");
+    for (uint i = 0; i < repeat; i++)
+    {
+        dot(Q, v, mutableView(x));
+    }
+    t.whatTime();
+
+    auto sell = spmatrix2sell(Q);
+    for (auto kernel :
+         {SellKernel::Scalar, SellKernel::Avx2, SellKernel::Avx512})
+    {
+        const char* name[] = {"sell scalar", "sell avx2", "sell avx512"};
+        timer ts(name[(uint)kernel]);
+        for (uint i = 0; i < repeat; i++)
+        {
+            dot(sell, v, mutableView(x), kernel);
+        }
+        ts.whatTime();
+    }
+
+    auto compact = spmatrix2compact(Q);
+    std::cout << "far indices: " << compact.nfar << std::endl;
+    std::cout << "index bytes per nonzero, csr: "
+              << (Real)((Q.ptr.size() + Q.idx.size()) * sizeof(uint)) /
+                     (Real)Q.val.size()
+              << ", compact csr: "
+              << (Real)compact.indexBytes() / (Real)Q.val.size() << std::endl;
+    std::cout << "total bytes per nonzero, csr: "
+              << (Real)((Q.ptr.size() + Q.idx.size()) * sizeof(uint) +
+                        Q.val.size() * sizeof(Real)) /
+                     (Real)Q.val.size()
+              << ", compact csr: "
+              << (Real)(compact.indexBytes() +
+                        compact.val.size() * sizeof(Real)) /
+                     (Real)Q.val.size()
+              << std::endl;
+    timer tc("compact csr");
+    for (uint i = 0; i < repeat; i++)
+    {
+        dot(compact, v, mutableView(x));
+    }
+    tc.whatTime();
+}
+
+static void compareSor(const Spmatrix& Q, uint nIter)
+{
+    Vector prob(Q.nrow, 1.0);
+    timer t("csr sor");
+    srnSteadyStateSor(Q, mutableView(prob), 1.0, 0.0, nIter);
+    t.whatTime();
+
+    auto compact = spmatrix2compact(Q);
+    Vector prob_compact(Q.nrow, 1.0);
+    timer tc("compact csr sor");
+    srnSteadyStateSor(compact, mutableView(prob_compact), 1.0, 0.0, nIter);
+    tc.whatTime();
+    ASSERT_EQ(maxDiff(prob, prob_compact), 0.0);
+}
+
+TEST(spmv_timing, multi_stage)
+{
+    compareSpmv(multiStageGenerator(5, 12), 100);
+}
+
+TEST(spmv_timing, many_parallel)
+{
+    compareSpmv(manyParallelGenerator(18), 100);
+}
+
+TEST(spmv_timing, multi_stage_sor)
+{
+    compareSor(multiStageGenerator(5, 12), 20);
+}
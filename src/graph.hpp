@@ -1,6 +1,9 @@
 #pragma once
 
+#include "graph/csrgraph.hpp"
 #include "graph/decompose.hpp"
 #include "graph/digraph.hpp"
 #include "graph/graph.hpp"
+#include "graph/hash.hpp"
+#include "graph/reorder.hpp"
 #include "graph/search.hpp"
@@ -0,0 +1,19 @@
+#include "csrgraph.hpp"
+
+namespace sanity::graph
+{
+CsrDiGraph::CsrDiGraph(const DiGraph& g)
+    : _node_count(g.nodeCount()), _ptr(), _edges()
+{
+    _ptr.reserve(g.nodeCount() + 1);
+    _edges.reserve(g.edgeCount());
+    _ptr.push_back(0);
+    for (uint i = 0; i < g.nodeCount(); i++)
+    {
+        const auto& edges = g.getNode(i).edges;
+        _edges.insert(_edges.end(), edges.begin(), edges.end());
+        _ptr.push_back(_edges.size());
+    }
+}
+
+}  // namespace sanity::graph
@@ -0,0 +1,89 @@
+#pragma once
+#include <cassert>
+#include <vector>
+#include "digraph.hpp"
+#include "type.hpp"
+
+namespace sanity::graph
+{
+// Directed graph with all the edges in one array, grouped by their source
+// node (compressed sparse row). Traversal is the same as DiGraph's. Edges
+// can only be appended in nondecreasing order of their source node, which
+// is the order of a breadth-first state space generation.
+class CsrDiGraph
+{
+public:
+    using Edge = DiGraph::Edge;
+
+    class EdgeRange
+    {
+        const Edge* _begin;
+        const Edge* _end;
+
+    public:
+        EdgeRange(const Edge* begin, const Edge* end)
+            : _begin(begin), _end(end)
+        {
+        }
+        const Edge* begin() const { return _begin; }
+        const Edge* end() const { return _end; }
+        uint size() const { return (uint)(_end - _begin); }
+        bool empty() const { return _begin == _end; }
+        const Edge& operator[](uint i) const { return _begin[i]; }
+    };
+
+    struct Node
+    {
+        EdgeRange edges;
+    };
+
+    CsrDiGraph() : _node_count(0), _ptr(1, 0) {}
+    CsrDiGraph(uint node_count) : _node_count(node_count), _ptr(1, 0) {}
+    // the edge ids are kept
+    explicit CsrDiGraph(const DiGraph& g);
+
+    uint addNode() { return _node_count++; }
+    uint addEdge(uint src, uint dst)
+    {
+        assert(src < nodeCount());
+        assert(dst < nodeCount());
+        assert(src + 1 >= _ptr.size());  // edges of src are not closed
+        while (_ptr.size() <= src)
+        {  // close the previous source nodes
+            _ptr.push_back(edgeCount());
+        }
+        uint eid = edgeCount();
+        _edges.push_back({eid, dst});
+        return eid;
+    }
+    Node getNode(uint nid) const
+    {
+        assert(nid < nodeCount());
+        const Edge* edges = _edges.data();
+        if (nid + 1 < _ptr.size())
+        {
+            return {{edges + _ptr[nid], edges + _ptr[nid + 1]}};
+        }
+        else if (nid + 1 == _ptr.size())
+        {  // the last source node
+            return {{edges + _ptr[nid], edges + _edges.size()}};
+        }
+        else
+        {
+            return {{edges + _edges.size(), edges + _edges.size()}};
+        }
+    }
+    uint nodeCount() const { return _node_count; }
+    uint edgeCount() const { return _edges.size(); }
+    void reserveEdges(uint n) { _edges.reserve(n); }
+
+private:
+    uint _node_count;
+    // edges of node i are [_ptr[i], _ptr[i + 1]). the edges of the last
+    // node of _ptr end at the end of _edges and the nodes after it have no
+    // edges.
+    std::vector<uint> _ptr;
+    std::vector<Edge> _edges;
+};
+
+}  // namespace sanity::graph
@@ -1,5 +1,11 @@
 
 #include "decompose.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include "parallel.hpp"
 #include "search.hpp"
 
 namespace sanity::graph
@@ -43,35 +49,49 @@ struct SccNode
     SccNode() : depth(0), lowlink(0), onstack(false) {}
 };
 
-static bool recursiveVisit(const DiGraph& g, std::vector<SccNode>& node_info,
-                           uint src_idx, uint& depth,
+// one frame of the explicit dfs stack
+struct SccFrame
+{
+    uint node;
+    uint nextEdge;
+    bool isBottom;
+};
+
+template <typename G>
+static void iterativeVisit(const G& g, std::vector<SccNode>& node_info,
+                           uint root, uint& depth,
+                           std::vector<SccFrame>& frames,
                            std::vector<uint>& node_stack,
                            std::vector<StronglyConnectedComponent>& scc_list)
 {
-    auto& src_node = node_info[src_idx];
-    src_node.depth = depth;
-    src_node.lowlink = depth;
-    src_node.onstack = true;
-    depth += 1;
-    node_stack.push_back(src_idx);
-    bool is_bottom = true;
-    for (const auto& edge : g.getNode(src_idx).edges)
+    auto enter = [&](uint idx) {
+        auto& info = node_info[idx];
+        info.depth = depth;
+        info.lowlink = depth;
+        info.onstack = true;
+        depth += 1;
+        node_stack.push_back(idx);
+        frames.push_back({idx, 0, true});
+    };
+    enter(root);
+    while (!frames.empty())
     {
-        uint dst_idx = edge.dst;
-        if (dst_idx != src_idx)
+        auto& frame = frames.back();
+        uint src_idx = frame.node;
+        auto& src_node = node_info[src_idx];
+        const auto& edges = g.getNode(src_idx).edges;
+        if (frame.nextEdge < edges.size())
         {
+            uint dst_idx = edges[frame.nextEdge].dst;
+            frame.nextEdge += 1;
+            if (dst_idx == src_idx)
+            {
+                continue;
+            }
             auto& dst_node_info = node_info[dst_idx];
             if (dst_node_info.depth == 0)
             {
-                if (!recursiveVisit(g, node_info, dst_idx, depth, node_stack,
-                                    scc_list))
-                {
-                    is_bottom = false;
-                }
-                if (src_node.lowlink > dst_node_info.lowlink)
-                {
-                    src_node.lowlink = dst_node_info.lowlink;
-                }
+                enter(dst_idx);  // frame is invalidated
             }
             else if (dst_node_info.onstack)
             {
@@ -82,45 +102,390 @@ static bool recursiveVisit(const DiGraph& g, std::vector<SccNode>& node_info,
             }
             else
             {
-                is_bottom = false;
+                frame.isBottom = false;
             }
+            continue;
         }
-    }
 
-    if (src_node.lowlink == src_node.depth)
-    {
-        std::vector<uint> node_list;
-        size_t top_node_idx;
-        do
-        {
-            top_node_idx = node_stack.back();
-            node_stack.pop_back();
-            node_list.push_back(top_node_idx);
-            node_info[top_node_idx].onstack = false;
-        } while (top_node_idx != src_idx);
-        scc_list.push_back({std::move(node_list), is_bottom});
-        return false;
-    }
-    else
-    {
-        return is_bottom;
+        // all edges are visited
+        bool is_bottom = frame.isBottom;
+        frames.pop_back();
+        if (src_node.lowlink == src_node.depth)
+        {
+            std::vector<uint> node_list;
+            size_t top_node_idx;
+            do
+            {
+                top_node_idx = node_stack.back();
+                node_stack.pop_back();
+                node_list.push_back(top_node_idx);
+                node_info[top_node_idx].onstack = false;
+            } while (top_node_idx != src_idx);
+            scc_list.push_back({std::move(node_list), is_bottom});
+            is_bottom = false;  // the parent has an edge leaving its scc
+        }
+        if (!frames.empty())
+        {
+            auto& parent = frames.back();
+            auto& parent_node = node_info[parent.node];
+            if (!is_bottom)
+            {
+                parent.isBottom = false;
+            }
+            if (parent_node.lowlink > src_node.lowlink)
+            {
+                parent_node.lowlink = src_node.lowlink;
+            }
+        }
     }
 }
 
-std::vector<StronglyConnectedComponent> decompScc(const DiGraph& g)
+template <typename G>
+static std::vector<StronglyConnectedComponent> decompSccT(const G& g)
 {
     std::vector<StronglyConnectedComponent> scc_list;
     std::vector<SccNode> node_info(g.nodeCount());
     std::vector<uint> scc_stack;
+    std::vector<SccFrame> frames;
     uint depth = 1;
     for (uint i = 0; i < g.nodeCount(); i++)
     {
         if (node_info[i].depth == 0)
         {
-            recursiveVisit(g, node_info, i, depth, scc_stack, scc_list);
+            iterativeVisit(g, node_info, i, depth, frames, scc_stack,
+                           scc_list);
         }
     }
     return scc_list;
 }
 
+static const uint noComp = std::numeric_limits<uint>::max();
+// the color of trimmed nodes, which no subproblem has
+static const uint noColor = std::numeric_limits<uint>::max();
+
+// the shared state of the parallel scc decomposition
+template <typename G>
+struct ParallelScc
+{
+    const G& g;
+    std::vector<uint> inPtr;  // in-edges of every node
+    std::vector<uint> inSrc;
+    // scc id of every node, noComp if not decided yet
+    std::vector<std::atomic<uint>> comp;
+    // the subproblem of every undecided node. colors are never reused, so
+    // a node belongs to the subproblem being processed iff its color
+    // equals the color of the subproblem. trimmed nodes get noColor.
+    std::vector<std::atomic<uint>> color;
+    std::vector<uint> mark;  // only touched by the owner of the subproblem
+    std::atomic<uint> nextComp;
+    std::atomic<uint> nextColor;
+
+    ParallelScc(const G& g)
+        : g(g),
+          comp(g.nodeCount()),
+          color(g.nodeCount()),
+          mark(g.nodeCount(), 0),
+          nextComp(0),
+          nextColor(1)
+    {
+    }
+};
+
+template <typename G>
+static void buildInEdges(ParallelScc<G>& st)
+{
+    uint n = st.g.nodeCount();
+    st.inPtr.assign(n + 1, 0);
+    for (uint v = 0; v < n; v++)
+    {
+        for (const auto& edge : st.g.getNode(v).edges)
+        {
+            st.inPtr[edge.dst + 1] += 1;
+        }
+    }
+    for (uint v = 0; v < n; v++)
+    {
+        st.inPtr[v + 1] += st.inPtr[v];
+    }
+    st.inSrc.resize(st.inPtr[n]);
+    std::vector<uint> next(st.inPtr.begin(), st.inPtr.end() - 1);
+    for (uint v = 0; v < n; v++)
+    {
+        for (const auto& edge : st.g.getNode(v).edges)
+        {
+            st.inSrc[next[edge.dst]++] = v;
+        }
+    }
+}
+
+// Repeatedly removes undecided nodes without undecided predecessors or
+// successors, each of them being an scc of its own.
+template <typename G>
+static void trim(ParallelScc<G>& st, uint nthread)
+{
+    std::atomic<bool> changed(true);
+    auto undecided = [&](uint v) {
+        return st.comp[v].load(std::memory_order_relaxed) == noComp;
+    };
+    while (changed.load())
+    {
+        changed = false;
+        parallel::parallelFor(
+            0, st.g.nodeCount(), nthread, [&](uint, uint begin, uint end) {
+                for (uint v = begin; v < end; v++)
+                {
+                    if (!undecided(v))
+                    {
+                        continue;
+                    }
+                    bool has_out = false;
+                    for (const auto& edge : st.g.getNode(v).edges)
+                    {
+                        if (edge.dst != v && undecided(edge.dst))
+                        {
+                            has_out = true;
+                            break;
+                        }
+                    }
+                    bool has_in = false;
+                    for (uint k = st.inPtr[v]; k < st.inPtr[v + 1]; k++)
+                    {
+                        if (st.inSrc[k] != v && undecided(st.inSrc[k]))
+                        {
+                            has_in = true;
+                            break;
+                        }
+                    }
+                    if (!has_out || !has_in)
+                    {
+                        st.comp[v].store(st.nextComp.fetch_add(1),
+                                         std::memory_order_relaxed);
+                        st.color[v].store(noColor, std::memory_order_relaxed);
+                        changed.store(true, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+}
+
+// Splits a subproblem with the forward and backward reachable sets of a
+// pivot. Their intersection is an scc, and every other scc lies in one of
+// the three remaining sets, which are returned.
+template <typename G>
+static std::vector<std::vector<uint>> forwardBackward(
+    ParallelScc<G>& st, std::vector<uint> nodes, std::vector<uint>& queue)
+{
+    uint c = st.color[nodes[0]].load(std::memory_order_relaxed);
+    auto inSub = [&](uint v) {
+        return st.color[v].load(std::memory_order_relaxed) == c;
+    };
+    auto reach = [&](uint bit, bool forward) {
+        queue.clear();
+        queue.push_back(nodes[0]);
+        st.mark[nodes[0]] |= bit;
+        for (uint k = 0; k < queue.size(); k++)
+        {
+            uint v = queue[k];
+            auto visit = [&](uint w) {
+                if (inSub(w) && !(st.mark[w] & bit))
+                {
+                    st.mark[w] |= bit;
+                    queue.push_back(w);
+                }
+            };
+            if (forward)
+            {
+                for (const auto& edge : st.g.getNode(v).edges)
+                {
+                    visit(edge.dst);
+                }
+            }
+            else
+            {
+                for (uint e = st.inPtr[v]; e < st.inPtr[v + 1]; e++)
+                {
+                    visit(st.inSrc[e]);
+                }
+            }
+        }
+    };
+    reach(1, true);
+    reach(2, false);
+
+    uint scc_id = st.nextComp.fetch_add(1);
+    std::vector<std::vector<uint>> parts(3);
+    for (uint v : nodes)
+    {
+        uint m = st.mark[v];
+        st.mark[v] = 0;
+        if (m == 3)
+        {
+            st.comp[v].store(scc_id, std::memory_order_relaxed);
+        }
+        else
+        {
+            parts[m].push_back(v);
+        }
+    }
+    std::vector<std::vector<uint>> result;
+    for (auto& part : parts)
+    {
+        if (!part.empty())
+        {
+            uint new_color = st.nextColor.fetch_add(1);
+            for (uint v : part)
+            {
+                st.color[v].store(new_color, std::memory_order_relaxed);
+            }
+            result.push_back(std::move(part));
+        }
+    }
+    return result;
+}
+
+// every worker takes subproblems from a shared queue until all of them are
+// done
+template <typename G>
+static void forwardBackwardAll(ParallelScc<G>& st, std::vector<uint> nodes,
+                               uint nthread)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::vector<uint>> todo;
+    uint busy = 0;
+    bool failed = false;
+    if (!nodes.empty())
+    {
+        todo.push_back(std::move(nodes));
+    }
+    parallel::parallelFor(0, nthread, nthread, [&](uint, uint, uint) {
+        std::vector<uint> queue;
+        while (true)
+        {
+            std::vector<uint> sub;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock,
+                        [&] { return !todo.empty() || busy == 0 || failed; });
+                if (todo.empty() || failed)
+                {
+                    return;
+                }
+                sub = std::move(todo.back());
+                todo.pop_back();
+                busy += 1;
+            }
+            std::vector<std::vector<uint>> parts;
+            try
+            {
+                parts = forwardBackward(st, std::move(sub), queue);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                failed = true;
+                cv.notify_all();
+                throw;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                busy -= 1;
+                for (auto& part : parts)
+                {
+                    todo.push_back(std::move(part));
+                }
+            }
+            cv.notify_all();
+        }
+    });
+}
+
+template <typename G>
+static std::vector<StronglyConnectedComponent> decompSccParallelT(
+    const G& g, uint nthread)
+{
+    nthread = parallel::threadCount(nthread);
+    uint n = g.nodeCount();
+    ParallelScc<G> st(g);
+    parallel::parallelFor(0, n, nthread, [&](uint, uint begin, uint end) {
+        for (uint v = begin; v < end; v++)
+        {
+            st.comp[v].store(noComp, std::memory_order_relaxed);
+            st.color[v].store(0, std::memory_order_relaxed);
+        }
+    });
+    buildInEdges(st);
+    trim(st, nthread);
+    std::vector<uint> rest;
+    for (uint v = 0; v < n; v++)
+    {
+        if (st.comp[v].load(std::memory_order_relaxed) == noComp)
+        {
+            rest.push_back(v);
+        }
+    }
+    forwardBackwardAll(st, std::move(rest), nthread);
+
+    // number the sccs by their smallest node
+    uint ncomp = st.nextComp.load();
+    std::vector<uint> rank(ncomp, noComp);
+    std::vector<StronglyConnectedComponent> scc_list;
+    std::vector<uint> node_comp(n);
+    for (uint v = 0; v < n; v++)
+    {
+        uint c = st.comp[v].load(std::memory_order_relaxed);
+        if (rank[c] == noComp)
+        {
+            rank[c] = scc_list.size();
+            scc_list.push_back({{}, true});
+        }
+        node_comp[v] = rank[c];
+        scc_list[rank[c]].nodes.push_back(v);
+    }
+    std::vector<char> leaving(n, 0);
+    parallel::parallelFor(0, n, nthread, [&](uint, uint begin, uint end) {
+        for (uint v = begin; v < end; v++)
+        {
+            for (const auto& edge : g.getNode(v).edges)
+            {
+                if (node_comp[edge.dst] != node_comp[v])
+                {
+                    leaving[v] = 1;
+                    break;
+                }
+            }
+        }
+    });
+    for (uint v = 0; v < n; v++)
+    {
+        if (leaving[v])
+        {
+            scc_list[node_comp[v]].isBottom = false;
+        }
+    }
+    return scc_list;
+}
+
+std::vector<StronglyConnectedComponent> decompScc(const DiGraph& g)
+{
+    return decompSccT(g);
+}
+
+std::vector<StronglyConnectedComponent> decompScc(const CsrDiGraph& g)
+{
+    return decompSccT(g);
+}
+
+std::vector<StronglyConnectedComponent> decompSccParallel(const DiGraph& g,
+                                                          uint nthread)
+{
+    return decompSccParallelT(g, nthread);
+}
+
+std::vector<StronglyConnectedComponent> decompSccParallel(
+    const CsrDiGraph& g, uint nthread)
+{
+    return decompSccParallelT(g, nthread);
+}
+
 }  // namespace sanity::graph
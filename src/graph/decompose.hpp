@@ -1,5 +1,6 @@
 #pragma once
 
+#include "csrgraph.hpp"
 #include "digraph.hpp"
 #include "graph.hpp"
 
@@ -18,6 +19,17 @@ struct StronglyConnectedComponent
     bool isBottom;
 };
 
+// Tarjan's algorithm with an explicit stack. The sccs are in reverse
+// topological order.
 std::vector<StronglyConnectedComponent> decompScc(const DiGraph& g);
+std::vector<StronglyConnectedComponent> decompScc(const CsrDiGraph& g);
+
+// Trimming followed by forward-backward splitting, with nthread threads
+// (0 for every hardware thread). Gives the same sccs as decompScc, but
+// ordered by their smallest node, and with sorted node lists.
+std::vector<StronglyConnectedComponent> decompSccParallel(const DiGraph& g,
+                                                          uint nthread = 0);
+std::vector<StronglyConnectedComponent> decompSccParallel(
+    const CsrDiGraph& g, uint nthread = 0);
 
 }  // namespace sanity::graph
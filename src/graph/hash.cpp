@@ -0,0 +1,41 @@
+#include "hash.hpp"
+
+namespace sanity::graph
+{
+// FNV-1a over 32 bit words
+static const std::uint64_t fnvOffset = 14695981039346656037ull;
+static const std::uint64_t fnvPrime = 1099511628211ull;
+
+static std::uint64_t hashWord(std::uint64_t h, uint word)
+{
+    for (uint i = 0; i < 4; i++)
+    {
+        h ^= (word >> (8 * i)) & 0xffu;
+        h *= fnvPrime;
+    }
+    return h;
+}
+
+template <typename Graph>
+static std::uint64_t hashGraph(const Graph& g)
+{
+    std::uint64_t h = hashWord(fnvOffset, g.nodeCount());
+    h = hashWord(h, g.edgeCount());
+    for (uint src = 0; src < g.nodeCount(); src++)
+    {
+        const auto& edges = g.getNode(src).edges;
+        h = hashWord(h, (uint)edges.size());
+        for (const auto& e : edges)
+        {
+            h = hashWord(h, e.eid);
+            h = hashWord(h, e.dst);
+        }
+    }
+    return h;
+}
+
+std::uint64_t structuralHash(const DiGraph& g) { return hashGraph(g); }
+
+std::uint64_t structuralHash(const CsrDiGraph& g) { return hashGraph(g); }
+
+}  // namespace sanity::graph
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include "csrgraph.hpp"
+#include "digraph.hpp"
+
+namespace sanity::graph
+{
+// Hash of the node count and of every edge (source, id and destination).
+// Two graphs with the same hash can be assumed to produce rate matrices
+// with the same sparsity pattern, so it can key caches of solutions. A
+// DiGraph and the CsrDiGraph built from it have the same hash.
+std::uint64_t structuralHash(const DiGraph& g);
+std::uint64_t structuralHash(const CsrDiGraph& g);
+
+}  // namespace sanity::graph
@@ -0,0 +1,168 @@
+#include "reorder.hpp"
+#include <algorithm>
+
+namespace sanity::graph
+{
+using namespace linear;
+
+// undirected adjacency lists without self loops
+struct Adjacency
+{
+    std::vector<uint> ptr;
+    std::vector<uint> nodes;
+    uint degree(uint v) const { return ptr[v + 1] - ptr[v]; }
+};
+
+template <typename G>
+static Adjacency undirectedAdjacency(const G& g)
+{
+    uint n = g.nodeCount();
+    Adjacency adj;
+    adj.ptr.assign(n + 1, 0);
+    for (uint v = 0; v < n; v++)
+    {
+        for (const auto& edge : g.getNode(v).edges)
+        {
+            if (edge.dst != v)
+            {
+                adj.ptr[v + 1] += 1;
+                adj.ptr[edge.dst + 1] += 1;
+            }
+        }
+    }
+    for (uint v = 0; v < n; v++)
+    {
+        adj.ptr[v + 1] += adj.ptr[v];
+    }
+    adj.nodes.resize(adj.ptr[n]);
+    std::vector<uint> next(adj.ptr.begin(), adj.ptr.end() - 1);
+    for (uint v = 0; v < n; v++)
+    {
+        for (const auto& edge : g.getNode(v).edges)
+        {
+            if (edge.dst != v)
+            {
+                adj.nodes[next[v]++] = edge.dst;
+                adj.nodes[next[edge.dst]++] = v;
+            }
+        }
+    }
+    return adj;
+}
+
+struct LevelStructure
+{
+    uint nlevel;
+    uint lastLevel;  // the index in order where the last level starts
+};
+
+// Breadth-first search from root over the unmarked nodes. The nodes are
+// appended to order, and the neighbors of every node are visited by
+// increasing degree. mark is restored afterwards unless keep_mark is set.
+static LevelStructure levelSearch(const Adjacency& adj, uint root,
+                                  std::vector<char>& mark,
+                                  std::vector<uint>& order, bool keep_mark)
+{
+    uint start = order.size();
+    order.push_back(root);
+    mark[root] = 1;
+    LevelStructure ls{0, start};
+    uint level_begin = start;
+    std::vector<uint> neighbors;
+    while (level_begin < order.size())
+    {
+        ls.nlevel += 1;
+        ls.lastLevel = level_begin;
+        uint level_end = order.size();
+        for (uint k = level_begin; k < level_end; k++)
+        {
+            uint v = order[k];
+            neighbors.clear();
+            for (uint e = adj.ptr[v]; e < adj.ptr[v + 1]; e++)
+            {
+                uint w = adj.nodes[e];
+                if (!mark[w])
+                {
+                    mark[w] = 1;
+                    neighbors.push_back(w);
+                }
+            }
+            std::sort(neighbors.begin(), neighbors.end(),
+                      [&](uint w1, uint w2) {
+                          return adj.degree(w1) < adj.degree(w2);
+                      });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+        level_begin = level_end;
+    }
+    if (!keep_mark)
+    {
+        for (uint k = start; k < order.size(); k++)
+        {
+            mark[order[k]] = 0;
+        }
+    }
+    return ls;
+}
+
+// George-Liu: move to a node of minimum degree in the last level as long
+// as the number of levels grows
+static uint pseudoPeripheralNode(const Adjacency& adj, uint root,
+                                 std::vector<char>& mark,
+                                 std::vector<uint>& buffer)
+{
+    buffer.clear();
+    auto ls = levelSearch(adj, root, mark, buffer, false);
+    while (true)
+    {
+        uint candidate = buffer[ls.lastLevel];
+        for (uint k = ls.lastLevel; k < buffer.size(); k++)
+        {
+            if (adj.degree(buffer[k]) < adj.degree(candidate))
+            {
+                candidate = buffer[k];
+            }
+        }
+        buffer.clear();
+        auto candidate_ls = levelSearch(adj, candidate, mark, buffer, false);
+        if (candidate_ls.nlevel <= ls.nlevel)
+        {
+            return root;
+        }
+        root = candidate;
+        ls = candidate_ls;
+    }
+}
+
+template <typename G>
+static Permutation reverseCuthillMckeeT(const G& g)
+{
+    uint n = g.nodeCount();
+    auto adj = undirectedAdjacency(g);
+    std::vector<char> mark(n, 0);
+    std::vector<uint> order;
+    order.reserve(n);
+    std::vector<uint> buffer;
+    for (uint v = 0; v < n; v++)
+    {
+        if (!mark[v])
+        {
+            uint root = pseudoPeripheralNode(adj, v, mark, buffer);
+            levelSearch(adj, root, mark, order, true);
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return Permutation(std::move(order), true);
+}
+
+Permutation reverseCuthillMckee(const DiGraph& g)
+{
+    return reverseCuthillMckeeT(g);
+}
+
+Permutation reverseCuthillMckee(const CsrDiGraph& g)
+{
+    return reverseCuthillMckeeT(g);
+}
+
+}  // namespace sanity::graph
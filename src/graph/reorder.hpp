@@ -0,0 +1,15 @@
+#pragma once
+#include "csrgraph.hpp"
+#include "digraph.hpp"
+#include "linear.hpp"
+
+namespace sanity::graph
+{
+// Reverse Cuthill-McKee ordering of the graph with its edge directions
+// ignored. Every connected component is started from a pseudo-peripheral
+// node. forward(new index) gives the node, so the result can be used as
+// the matrix2node permutation of a solver.
+linear::Permutation reverseCuthillMckee(const DiGraph& g);
+linear::Permutation reverseCuthillMckee(const CsrDiGraph& g);
+
+}  // namespace sanity::graph
@@ -1,6 +1,6 @@
 #include "decomp.hpp"
 #include <algorithm>
-#include <iostream>
+#include <stdexcept>
 #include "utils.hpp"
 
 namespace sanity::linear
@@ -30,4 +30,38 @@ ResDecompQR decompQR(MatrixConstView A)
     auto work = createMatrix(A);
     return decompQR(mutableView(work));
 }
+
+std::vector<Complex> eigenvaluesHessenberg(MatrixConstView H)
+{
+    assert(H.nrow() == H.ncol());
+    uint n = H.nrow();
+    if (n == 0)
+    {
+        return {};
+    }
+    Matrix work(n, n, 0.0);
+    for (uint i = 0; i < n; i++)
+    {
+        for (uint j = i > 0 ? i - 1 : 0; j < n; j++)
+        {
+            work(i, j) = H(i, j);
+        }
+    }
+    Vector wr(n);
+    Vector wi(n);
+    int info = lapack::hseqr(mutableView(work), mutableView(wr),
+                             mutableView(wi));
+    if (info != 0)
+    {
+        throw std::invalid_argument(
+            "eigenvaluesHessenberg: dhseqr failed to converge.");
+    }
+    std::vector<Complex> eigs;
+    for (uint i = 0; i < n; i++)
+    {
+        eigs.push_back(Complex(wr(i), wi(i)));
+    }
+    return eigs;
+}
+
 }  // namespace sanity::linear
@@ -14,4 +14,10 @@ struct ResDecompQR
 // A = QR
 ResDecompQR decompQR(MatrixMutableView A);
 ResDecompQR decompQR(MatrixConstView A);
+
+// Eigenvalues of an upper Hessenberg matrix, computed by LAPACK dhseqr
+// (multishift Francis QR), in no particular order. Entries below the
+// subdiagonal are ignored. Throws std::invalid_argument if dhseqr does not
+// converge.
+std::vector<Complex> eigenvaluesHessenberg(MatrixConstView H);
 }  // namespace sanity::linear
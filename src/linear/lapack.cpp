@@ -1,4 +1,5 @@
 #include "lapack.hpp"
+#include <algorithm>
 #define HAVE_LAPACK_CONFIG_H
 #define LAPACK_COMPLEX_CPP
 #include <lapacke.h>
@@ -39,4 +40,15 @@ int gesv(MatrixMutableView A, MatrixMutableView B, std::vector<int>* perm)
     return LAPACKE_dgesv(order, (int)n, (int)B.ncol(), &A(0, 0),
                          (int)A.ldim(), perm_ptr, &B(0, 0), (int)B.ldim());
 }
+
+int hseqr(MatrixMutableView H, VectorMutableView wr, VectorMutableView wi)
+{
+    assert(H.nrow() == H.ncol());
+    assert(wr.size() == H.nrow() && wi.size() == H.nrow());
+    assert(wr.inc() == 1 && wi.inc() == 1);
+    int n = (int)H.nrow();
+    // eigenvalues only, so the Schur vectors z are not referenced
+    return LAPACKE_dhseqr(order, 'E', 'N', n, 1, n, &H(0, 0), (int)H.ldim(),
+                          &wr(0), &wi(0), nullptr, std::max(n, 1));
+}
 }  // namespace sanity::linear::lapack
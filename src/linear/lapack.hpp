@@ -12,4 +12,7 @@ int orgqr(MatrixMutableView mA, VectorConstView tau);
 int gesv(MatrixMutableView A, MatrixMutableView B,
          std::vector<int> *perm = nullptr);
 
+// eigenvalues of the upper Hessenberg matrix H, which is overwritten
+int hseqr(MatrixMutableView H, VectorMutableView wr, VectorMutableView wi);
+
 }  // namespace sanity::linear::lapack
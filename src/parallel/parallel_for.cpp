@@ -0,0 +1,101 @@
+#include "parallel_for.hpp"
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace sanity::parallel
+{
+uint threadCount(uint nthread)
+{
+    if (nthread == 0)
+    {
+        nthread = std::thread::hardware_concurrency();
+    }
+    return nthread == 0 ? 1 : nthread;
+}
+
+uint blockBegin(uint begin, uint end, uint nthread, uint tid)
+{
+    assert(begin <= end);
+    assert(tid <= nthread);
+    return begin + (uint)((unsigned long long)(end - begin) * tid / nthread);
+}
+
+void parallelFor(uint begin, uint end, uint nthread, const BlockFn& fn)
+{
+    nthread = threadCount(nthread);
+    if (nthread == 1)
+    {
+        fn(0, begin, end);
+        return;
+    }
+    std::vector<std::exception_ptr> errors(nthread);
+    auto run = [&](uint tid) {
+        try
+        {
+            fn(tid, blockBegin(begin, end, nthread, tid),
+               blockBegin(begin, end, nthread, tid + 1));
+        }
+        catch (...)
+        {
+            errors[tid] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nthread - 1);
+    for (uint tid = 1; tid < nthread; tid++)
+    {
+        threads.emplace_back(run, tid);
+    }
+    run(0);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    for (const auto& e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+void parallelForDynamic(uint begin, uint end, uint nthread, const ItemFn& fn)
+{
+    assert(begin <= end);
+    if (begin == end)
+    {
+        return;
+    }
+    nthread = threadCount(nthread);
+    if (nthread > end - begin)
+    {
+        nthread = end - begin;
+    }
+    std::atomic<uint> next(begin);
+    std::atomic<bool> failed(false);
+    parallelFor(0, nthread, nthread, [&](uint tid, uint, uint) {
+        while (!failed.load(std::memory_order_relaxed))
+        {
+            uint i = next.fetch_add(1);
+            if (i >= end)
+            {
+                break;
+            }
+            try
+            {
+                fn(tid, i);
+            }
+            catch (...)
+            {
+                failed = true;
+                throw;
+            }
+        }
+    });
+}
+
+}  // namespace sanity::parallel
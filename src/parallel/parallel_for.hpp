@@ -0,0 +1,29 @@
+#pragma once
+#include <functional>
+#include "type.hpp"
+
+namespace sanity::parallel
+{
+using BlockFn = std::function<void(uint tid, uint begin, uint end)>;
+using ItemFn = std::function<void(uint tid, uint i)>;
+
+// nthread == 0 means one thread per hardware thread
+uint threadCount(uint nthread);
+
+// Splits [begin, end) into nthread contiguous blocks of nearly equal size
+// and calls fn(tid, block_begin, block_end) for each of them, block tid
+// running on its own thread (block 0 runs on the calling thread). Returns
+// after every block is done. If any call throws, the exception of the
+// lowest tid is rethrown.
+void parallelFor(uint begin, uint end, uint nthread, const BlockFn& fn);
+
+// Calls fn(tid, i) for every i in [begin, end), the threads taking the next
+// index whenever they are done with one. Suits items of uneven cost. After
+// an exception, no new item is started and the exception is rethrown.
+void parallelForDynamic(uint begin, uint end, uint nthread, const ItemFn& fn);
+
+// the first index of the block of thread tid, nthread being the resolved
+// thread count
+uint blockBegin(uint begin, uint end, uint nthread, uint tid);
+
+}  // namespace sanity::parallel
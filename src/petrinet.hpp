@@ -7,6 +7,9 @@
 #include "petrinet/poisson_trunc.hpp"
 #include "petrinet/reach.hpp"
 #include "petrinet/srn.hpp"
+#include "petrinet/srncache.hpp"
+#include "petrinet/srngen.hpp"
+#include "petrinet/srnkron.hpp"
 #include "petrinet/srnreach.hpp"
 #include "petrinet/srnreward.hpp"
 #include "petrinet/srnssolve.hpp"
@@ -73,8 +73,8 @@ GeneralPetriNet GpnCreator::create() const
         trans.push_back(t->_trans);
         props.push_back(t->_prop);
     }
-    return {.pnet = PetriNet(_init_token.size(), _g_enable, std::move(trans)),
-            .transProps = std::move(props)};
+    return GeneralPetriNet(PetriNet(_init_token.size(), _g_enable, std::move(trans)),
+            std::move(props));
 }
 
 }  // namespace sanity::petrinet
@@ -1,5 +1,8 @@
 #include "gpn_ob.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 #include "utils.hpp"
 
 namespace sanity::petrinet
@@ -72,13 +75,15 @@ void GpnObProbReward::updateReward(const GpnSimulator::Event& evt,
     {
         time = evt.time;
     }
-    _acc_reward += (time - _last_time) * _last_reward;
+    // the previous event may lie before the window
+    Real since = std::max(_last_time, _begin_time);
+    _acc_reward += (time - since) * _last_reward;
 }
 void GpnObProbReward::end(const GpnSimulator::Event& evt,
                           const GpnSimulator::State& state,
                           const GpnSimulator::EventQueue& queue)
 {
-    _samples.push_back(_acc_reward / timeSpan());
+    _samples.add(_acc_reward / timeSpan());
 }
 
 void GpnObCumReward::reset(const GpnSimulator::Event& evt,
@@ -107,13 +112,77 @@ void GpnObCumReward::updateReward(const GpnSimulator::Event& evt,
     {
         time = evt.time;
     }
-    _acc_reward += (time - _last_time) * _last_reward;
+    // the previous event may lie before the window
+    Real since = std::max(_last_time, _begin_time);
+    _acc_reward += (time - since) * _last_reward;
 }
 void GpnObCumReward::end(const GpnSimulator::Event& evt,
                          const GpnSimulator::State& state,
                          const GpnSimulator::EventQueue& queue)
 {
-    _samples.push_back(_acc_reward);
+    _samples.add(_acc_reward);
+}
+
+GpnObBatchMeans::GpnObBatchMeans(Real interval, MarkingDepReal reward,
+                                 uint nbatch)
+    : GpnObserver(0, INFINITY),
+      _interval(interval),
+      _nbatch(nbatch),
+      _reward(reward),
+      _truncation(0)
+{
+    if (!(interval > 0))
+    {
+        throw std::invalid_argument("Interval length must be positive.");
+    }
+    if (nbatch == 0)
+    {
+        throw std::invalid_argument(
+            "The number of batches must be positive.");
+    }
+}
+void GpnObBatchMeans::reset(const GpnSimulator::Event& evt,
+                            const GpnSimulator::State& state,
+                            const GpnSimulator::EventQueue& queue)
+{
+    _acc_reward = 0;
+    _interval_begin = evt.time;
+    _observations.clear();
+}
+void GpnObBatchMeans::houseKeeping(const GpnSimulator::Event& evt,
+                                   const GpnSimulator::State& state,
+                                   const GpnSimulator::EventQueue& queue)
+{
+    _last_reward = _reward({&state.net, state.currMarking.get()});
+    _last_time = evt.time;
+}
+void GpnObBatchMeans::updateReward(const GpnSimulator::Event& evt,
+                                   const GpnSimulator::State& state,
+                                   const GpnSimulator::EventQueue& queue)
+{
+    Real since = _last_time;
+    while (_interval_begin + _interval <= evt.time)
+    {
+        Real boundary = _interval_begin + _interval;
+        _acc_reward += (boundary - since) * _last_reward;
+        _observations.push_back(_acc_reward / _interval);
+        _acc_reward = 0;
+        since = boundary;
+        _interval_begin = boundary;
+    }
+    _acc_reward += (evt.time - since) * _last_reward;
+}
+void GpnObBatchMeans::end(const GpnSimulator::Event& evt,
+                          const GpnSimulator::State& state,
+                          const GpnSimulator::EventQueue& queue)
+{
+    // the last, incomplete interval is dropped
+    _truncation = mser5Truncation(_observations);
+    auto means = batchMeans(_observations, _truncation, _nbatch);
+    for (Real m : means)
+    {
+        _samples.add(m);
+    }
 }
 
 void GpnObMtta::eventTriggered(const GpnSimulator::Event& evt,
@@ -122,7 +191,7 @@ void GpnObMtta::eventTriggered(const GpnSimulator::Event& evt,
 {
     if (evt.type == EventType::End)
     {
-        _samples.push_back(evt.time);
+        _samples.add(evt.time);
     }
 }
 
@@ -142,11 +211,10 @@ void GpnObLog::eventTriggered(const GpnSimulator::Event& evt,
     if (_log_queue)
     {
         std::cout << "queue {";
-        for (uint i = 0; i < queue.size(); i++)
+        for (const auto& e : queue.events())
         {
-            std::cout << "(" << (uint)queue.peek(i).type << ", "
-                      << queue.peek(i).time << ", " << queue.peek(i).data
-                      << ") ";
+            std::cout << "(" << (uint)e.type << ", " << e.time << ", "
+                      << e.data << ") ";
         }
         std::cout << "}" << std::endl;
     }
@@ -166,7 +234,7 @@ void GpnObEventCounter::eventTriggered(const GpnSimulator::Event& evt,
             break;
         case EventType::End:
             _counter += 1;
-            _samples.push_back(_counter);
+            _samples.add(_counter);
             break;
     }
 }
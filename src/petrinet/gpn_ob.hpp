@@ -31,15 +31,36 @@ public:
     Real timeSpan() const { return _end_time - _begin_time; }
 };
 
-class GpnObProbReward : public GpnObserver
+// The samples of an observer, one per run or batch. They are kept, or only
+// summarized, as set by keepSamples and sketchQuantiles.
+class GpnSampleObserver
+{
+protected:
+    simulate::SampleRecorder _samples;
+
+public:
+    const std::vector<Real>& samples() const { return _samples.samples(); }
+    const simulate::OnlineStats& stats() const { return _samples.stats(); }
+    const simulate::QuantileSketch& quantiles() const
+    {
+        return _samples.quantiles();
+    }
+    void keepSamples(bool keep) { _samples.keepSamples(keep); }
+    void sketchQuantiles(bool sketch) { _samples.sketchQuantiles(sketch); }
+    // appends the samples of other
+    void merge(const GpnSampleObserver& other)
+    {
+        _samples.merge(other._samples);
+    }
+};
+
+class GpnObProbReward : public GpnObserver, public GpnSampleObserver
 {
     Real _acc_reward;
     Real _last_reward;
     Real _last_time;
     MarkingDepReal _reward;
 
-    std::vector<Real> _samples;
-
 protected:
     virtual void reset(const GpnSimulator::Event& evt,
                        const GpnSimulator::State& state,
@@ -59,18 +80,15 @@ public:
         : GpnObserver(begin_time, end_time), _reward(reward)
     {
     }
-    const std::vector<Real>& samples() const { return _samples; }
 };
 
-class GpnObCumReward : public GpnObserver
+class GpnObCumReward : public GpnObserver, public GpnSampleObserver
 {
     Real _acc_reward;
     Real _last_reward;
     Real _last_time;
     MarkingDepReal _reward;
 
-    std::vector<Real> _samples;
-
 protected:
     virtual void reset(const GpnSimulator::Event& evt,
                        const GpnSimulator::State& state,
@@ -90,19 +108,58 @@ public:
         : GpnObserver(begin_time, end_time), _reward(reward)
     {
     }
-    const std::vector<Real>& samples() const { return _samples; }
 };
 
-class GpnObMtta : public GpnSimulator::Observer
+// Steady-state mean of a reward by batch means over one long run. The
+// run is cut into intervals of the given length from time 0 and the time
+// averaged reward of every completed interval is an observation. At the
+// end of the run, the warm-up is truncated by the MSER-5 rule and the
+// remaining observations are grouped into nbatch batches, whose means are
+// appended to samples(). The warm-up is thus paid once per run instead of
+// once per replication; a run of many times the warm-up length gives
+// nearly independent batch means for confidenceInterval.
+class GpnObBatchMeans : public GpnObserver, public GpnSampleObserver
 {
-    std::vector<Real> _samples;
+    Real _interval;
+    uint _nbatch;
+    Real _acc_reward;
+    Real _last_reward;
+    Real _last_time;
+    Real _interval_begin;
+    MarkingDepReal _reward;
+
+    std::vector<Real> _observations;
+    uint _truncation;
+
+protected:
+    virtual void reset(const GpnSimulator::Event& evt,
+                       const GpnSimulator::State& state,
+                       const GpnSimulator::EventQueue& queue);
+    virtual void houseKeeping(const GpnSimulator::Event& evt,
+                              const GpnSimulator::State& state,
+                              const GpnSimulator::EventQueue& queue);
+    virtual void updateReward(const GpnSimulator::Event& evt,
+                              const GpnSimulator::State& state,
+                              const GpnSimulator::EventQueue& queue);
+    virtual void end(const GpnSimulator::Event& evt,
+                     const GpnSimulator::State& state,
+                     const GpnSimulator::EventQueue& queue);
 
+public:
+    GpnObBatchMeans(Real interval, MarkingDepReal reward, uint nbatch = 20);
+    // the interval averages of the last run, including the warm-up
+    const std::vector<Real>& observations() const { return _observations; }
+    // the number of leading observations of the last run discarded
+    uint truncation() const { return _truncation; }
+    Real warmUpTime() const { return _truncation * _interval; }
+};
+
+class GpnObMtta : public GpnSimulator::Observer, public GpnSampleObserver
+{
 public:
     virtual void eventTriggered(
         const GpnSimulator::Event& evt, const GpnSimulator::State& state,
         const GpnSimulator::EventQueue& queue) override;
-
-    const std::vector<Real>& samples() const { return _samples; }
 };
 
 class GpnObLog : public GpnSimulator::Observer
@@ -133,16 +190,15 @@ public:
         const GpnSimulator::EventQueue& queue) override;
 };
 
-class GpnObEventCounter : public GpnSimulator::Observer
+class GpnObEventCounter : public GpnSimulator::Observer,
+                          public GpnSampleObserver
 {
-    std::vector<Real> _samples;
     uint _counter;
 
 public:
     virtual void eventTriggered(
         const GpnSimulator::Event& evt, const GpnSimulator::State& state,
         const GpnSimulator::EventQueue& queue) override;
-    const std::vector<Real>& samples() const { return _samples; }
     GpnObEventCounter() = default;
 };
 
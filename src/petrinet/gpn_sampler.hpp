@@ -11,6 +11,7 @@ public:
     GpnExpSampler(MarkingDepReal rate) : _rate(std::move(rate)) {}
     Real operator()(PetriNetState pstate,
                     std::function<Real()>& uniform_sampler) const;
+    const MarkingDepReal& rate() const { return _rate; }
 };
 
 }  // namespace sanity::petrinet
@@ -1,5 +1,10 @@
 #include "gpn_sim.hpp"
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <memory>
+#include <stdexcept>
+#include "gpn_sampler.hpp"
 #include "petrinet.hpp"
 #include "simulate.hpp"
 #include "type.hpp"
@@ -45,10 +50,11 @@ static uint whichSlot(const std::vector<Real>& weights, Real rand_val)
 static uint chooseFiringImmeTrans(const GeneralPetriNet& net,
                                   const MarkingIntf* marking,
                                   const std::vector<uint>& enabled_tids,
-                                  Real uniform_val)
+                                  Real uniform_val,
+                                  std::vector<Real>& weights)
 {
     assert(enabled_tids.size() > 0);
-    std::vector<Real> weights(enabled_tids.size());
+    weights.resize(enabled_tids.size());
     Real weight_sum = 0;
     for (uint i = 0; i < enabled_tids.size(); i++)
     {
@@ -70,13 +76,13 @@ static uint chooseFiringImmeTrans(const GeneralPetriNet& net,
 //     std::cout << "]" << std::endl;
 // }
 
-// a - b
-static std::vector<uint> setSub(std::vector<uint>& a, std::vector<uint>& b)
+// res = a - b
+static void setSub(std::vector<uint>& a, std::vector<uint>& b,
+                   std::vector<uint>& res)
 {
     std::sort(a.begin(), a.end());
     std::sort(b.begin(), b.end());
-    std::vector<uint> res;
-    res.reserve(a.size());
+    res.clear();
     auto b_iter = b.begin();
     for (uint v : a)
     {
@@ -99,30 +105,697 @@ static std::vector<uint> setSub(std::vector<uint>& a, std::vector<uint>& b)
             res.push_back(v);
         }
     }
-    return res;
+}
+
+// sets the current marking to the initial one, reusing its storage
+static void resetMarking(GpnSimState& state)
+{
+    if (state.currMarking)
+    {
+        for (uint pid = 0; pid < state.initMarking->size(); pid++)
+        {
+            state.currMarking->setToken(pid, state.initMarking->nToken(pid));
+        }
+    }
+    else
+    {
+        state.currMarking = state.initMarking->clone();
+    }
+}
+
+static const GpnExpSampler* expSampler(const GpnTransProp& prop)
+{
+    return prop.timed.sampler.target<GpnExpSampler>();
+}
+
+static bool exponentialNet(const GeneralPetriNet& net, bool constant_rates)
+{
+    bool found_timed = false;
+    uint timed_prio = 0;
+    for (uint tid = 0; tid < net.transCount(); tid++)
+    {
+        const auto& prop = net.transProps[tid];
+        if (prop.type != GpnTransType::Timed)
+        {
+            continue;
+        }
+        uint prio = net.getTransition(tid).prio;
+        const auto* sampler = expSampler(prop);
+        if (!sampler ||
+            (constant_rates && sampler->rate().markingDependent()) ||
+            (found_timed && prio != timed_prio))
+        {
+            return false;
+        }
+        found_timed = true;
+        timed_prio = prio;
+    }
+    for (uint tid = 0; tid < net.transCount(); tid++)
+    {
+        if (found_timed &&
+            net.transProps[tid].type == GpnTransType::Immediate &&
+            net.getTransition(tid).prio <= timed_prio)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool gpnDirectMethodApplies(const GeneralPetriNet& net)
+{
+    return exponentialNet(net, true);
+}
+
+bool gpnTauLeapApplies(const GeneralPetriNet& net)
+{
+    if (!exponentialNet(net, false))
+    {
+        return false;
+    }
+    for (uint tid = 0; tid < net.transCount(); tid++)
+    {
+        const auto& tr = net.getTransition(tid);
+        for (const auto* arcs :
+             {&tr.inputArcs, &tr.outputArcs, &tr.inhibitorArcs})
+        {
+            for (const auto& arc : *arcs)
+            {
+                if (arc.multi.markingDependent())
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// the part of the direct method that only depends on the net
+struct DirectMethodModel
+{
+    std::vector<bool> timed;
+    std::vector<MarkingDepReal> rates;
+    // the transitions whose enabling may change when tid fires are
+    // depIdx[depPtr[tid]], ..., depIdx[depPtr[tid + 1] - 1]
+    std::vector<uint> depPtr;
+    std::vector<uint> depIdx;
+};
+
+static std::shared_ptr<const DirectMethodModel> directMethodModel(
+    const GeneralPetriNet& net)
+{
+    auto model = std::make_shared<DirectMethodModel>();
+    uint ntrans = net.transCount();
+    model->timed.resize(ntrans);
+    model->rates.resize(ntrans);
+    // transitions reading a place through an arc, and the ones reading the
+    // marking through a function, which depend on every firing
+    std::vector<std::vector<uint>> readers(net.placeCount());
+    std::vector<uint> opaque;
+    bool global_dep = net.globalEnabling().markingDependent();
+    for (uint tid = 0; tid < ntrans; tid++)
+    {
+        const auto& tr = net.getTransition(tid);
+        const auto& prop = net.transProps[tid];
+        model->timed[tid] = prop.type == GpnTransType::Timed;
+        if (model->timed[tid])
+        {
+            model->rates[tid] = expSampler(prop)->rate();
+        }
+        bool dep = global_dep || tr.enablingFunc.markingDependent();
+        for (const auto* arcs : {&tr.inputArcs, &tr.inhibitorArcs})
+        {
+            for (const auto& arc : *arcs)
+            {
+                dep = dep || arc.multi.markingDependent();
+            }
+        }
+        if (dep)
+        {
+            opaque.push_back(tid);
+            continue;
+        }
+        for (const auto* arcs : {&tr.inputArcs, &tr.inhibitorArcs})
+        {
+            for (const auto& arc : *arcs)
+            {
+                readers[arc.pid].push_back(tid);
+            }
+        }
+    }
+    std::vector<uint> last_added(ntrans, ntrans);
+    for (uint tid = 0; tid < ntrans; tid++)
+    {
+        model->depPtr.push_back(model->depIdx.size());
+        const auto& tr = net.getTransition(tid);
+        auto add = [&](uint dep) {
+            if (last_added[dep] != tid)
+            {
+                last_added[dep] = tid;
+                model->depIdx.push_back(dep);
+            }
+        };
+        for (uint dep : opaque)
+        {
+            add(dep);
+        }
+        for (const auto* arcs : {&tr.inputArcs, &tr.outputArcs})
+        {
+            for (const auto& arc : *arcs)
+            {
+                for (uint dep : readers[arc.pid])
+                {
+                    add(dep);
+                }
+            }
+        }
+    }
+    model->depPtr.push_back(model->depIdx.size());
+    return model;
+}
+
+static void updateTrans(const DirectMethodModel& model, GpnSimState& state,
+                        uint tid)
+{
+    const MarkingIntf* mk = state.currMarking.get();
+    bool enabled = state.net.isTransitionEnabledIsolated(tid, mk);
+    if (model.timed[tid])
+    {
+        state.timedRates.set(
+            tid, enabled ? model.rates[tid]({&state.net, mk}) : 0.0);
+    }
+    else if (enabled != state.immEnabled[tid])
+    {
+        state.immEnabled[tid] = enabled;
+        if (enabled)
+        {
+            state.immEnabledCount++;
+        }
+        else
+        {
+            state.immEnabledCount--;
+        }
+    }
+}
+
+static void scheduleNextFiring(GpnSimState& state,
+                               GpnSimulator::EventQueue& queue, Real now)
+{
+    if (state.immEnabledCount > 0)
+    {  // vanishing marking, the priorities decide among the immediates
+        state.net.enabledTransitions(state.currMarking.get(),
+                                     state.enabledTrans);
+        uint next_tid = chooseFiringImmeTrans(
+            state.net, state.currMarking.get(), state.enabledTrans,
+            state.uniformSampler(), state.weights);
+        queue.schedule(now, next_tid);
+        return;
+    }
+    Real total = state.timedRates.total();
+    if (total > 0.0)
+    {
+        Real delay = -std::log(state.uniformSampler()) / total;
+        uint next_tid = state.timedRates.find(state.uniformSampler() * total);
+        queue.schedule(now + delay, next_tid);
+    }
+}
+
+static void directMethodHandlers(GpnSimulator& sim)
+{
+    auto model = directMethodModel(sim.state().net);
+    sim.handler(EventType::Begin, [model](GpnSimulator::Event evt,
+                                          GpnSimulator::State& state,
+                                          GpnSimulator::EventQueue& queue) {
+        resetMarking(state);
+        uint ntrans = state.net.transCount();
+        if (state.timedRates.size() == ntrans)
+        {
+            state.timedRates.clear();
+        }
+        else
+        {
+            state.timedRates = SumTree(ntrans);
+        }
+        state.immEnabled.assign(ntrans, false);
+        state.immEnabledCount = 0;
+        for (uint tid = 0; tid < ntrans; tid++)
+        {
+            updateTrans(*model, state, tid);
+        }
+        scheduleNextFiring(state, queue, evt.time);
+    });
+    sim.handler(EventType::User, [model](GpnSimulator::Event evt,
+                                         GpnSimulator::State& state,
+                                         GpnSimulator::EventQueue& queue) {
+        uint firing_tid = evt.data;
+        state.net.fireTransitionInPlace(firing_tid, *state.currMarking);
+        for (uint i = model->depPtr[firing_tid];
+             i < model->depPtr[firing_tid + 1]; i++)
+        {
+            updateTrans(*model, state, model->depIdx[i]);
+        }
+        scheduleNextFiring(state, queue, evt.time);
+    });
+}
+
+// the part of tau-leaping that only depends on the net
+struct TauLeapModel
+{
+    struct Change
+    {
+        uint pid;
+        long long tokens;
+    };
+    struct ArcLimit
+    {
+        uint pid;
+        uint multi;
+    };
+    GpnTauLeapOptions options;
+    std::vector<MarkingDepReal> rates;
+    std::vector<std::vector<Change>> changes;      // nonzero ones only
+    std::vector<std::vector<ArcLimit>> inputs;     // by transition
+    std::vector<std::vector<ArcLimit>> inhibitors;  // by transition
+};
+
+static std::shared_ptr<const TauLeapModel> tauLeapModel(
+    const GeneralPetriNet& net, GpnTauLeapOptions options)
+{
+    auto model = std::make_shared<TauLeapModel>();
+    uint ntrans = net.transCount();
+    model->options = options;
+    model->rates.resize(ntrans);
+    model->changes.resize(ntrans);
+    model->inputs.resize(ntrans);
+    model->inhibitors.resize(ntrans);
+    // the multiplicities are constant, so no marking is needed
+    auto multi = [&](const Arc& arc) { return arc.multi({&net, nullptr}); };
+    std::vector<long long> change(net.placeCount(), 0);
+    for (uint tid = 0; tid < ntrans; tid++)
+    {
+        const auto& tr = net.getTransition(tid);
+        if (net.transProps[tid].type == GpnTransType::Timed)
+        {
+            model->rates[tid] = expSampler(net.transProps[tid])->rate();
+        }
+        for (const auto& arc : tr.inputArcs)
+        {
+            change[arc.pid] -= multi(arc);
+            model->inputs[tid].push_back({arc.pid, multi(arc)});
+        }
+        for (const auto& arc : tr.outputArcs)
+        {
+            change[arc.pid] += multi(arc);
+        }
+        for (const auto& arc : tr.inhibitorArcs)
+        {
+            model->inhibitors[tid].push_back({arc.pid, multi(arc)});
+        }
+        for (const auto* arcs : {&tr.inputArcs, &tr.outputArcs})
+        {
+            for (const auto& arc : *arcs)
+            {
+                if (change[arc.pid] != 0)
+                {
+                    model->changes[tid].push_back({arc.pid, change[arc.pid]});
+                    change[arc.pid] = 0;
+                }
+            }
+        }
+    }
+    return model;
+}
+
+static long long placeChange(const TauLeapModel& model, uint tid, uint pid)
+{
+    for (const auto& c : model.changes[tid])
+    {
+        if (c.pid == pid)
+        {
+            return c.tokens;
+        }
+    }
+    return 0;
+}
+
+// how many times tid can fire in a row before its own firings disable it
+static Real firingLimit(const TauLeapModel& model, uint tid,
+                        const MarkingIntf* mk)
+{
+    Real limit = INFINITY;
+    for (const auto& arc : model.inputs[tid])
+    {
+        long long change = placeChange(model, tid, arc.pid);
+        if (change < 0)
+        {
+            Real spare = (Real)mk->nToken(arc.pid) - arc.multi;
+            limit = std::min(limit, std::floor(spare / -change) + 1);
+        }
+    }
+    for (const auto& arc : model.inhibitors[tid])
+    {
+        long long change = placeChange(model, tid, arc.pid);
+        if (change > 0)
+        {
+            Real room = (Real)arc.multi - 1 - mk->nToken(arc.pid);
+            limit = std::min(limit, std::floor(room / change) + 1);
+        }
+    }
+    return limit;
+}
+
+// the CGP step bound of the noncritical transitions: the expected change
+// and the standard deviation of the change of every input place stay
+// within max(epsilon * tokens, 1)
+static Real noncriticalTau(const TauLeapModel& model, GpnTauLeapState& leap,
+                           const std::vector<bool>& critical,
+                           const MarkingIntf* mk)
+{
+    uint n = leap.timedEnabled.size();
+    for (uint i = 0; i < n; i++)
+    {
+        if (critical[i])
+        {
+            continue;
+        }
+        Real a = leap.propensities[i];
+        for (const auto& c : model.changes[leap.timedEnabled[i]])
+        {
+            leap.drift[c.pid] += c.tokens * a;
+            leap.spread[c.pid] += (Real)c.tokens * c.tokens * a;
+        }
+    }
+    Real tau = INFINITY;
+    for (uint i = 0; i < n; i++)
+    {
+        if (critical[i])
+        {
+            continue;
+        }
+        for (const auto& arc : model.inputs[leap.timedEnabled[i]])
+        {
+            Real bound =
+                std::max(model.options.epsilon * mk->nToken(arc.pid), 1.0);
+            Real drift = std::fabs(leap.drift[arc.pid]);
+            Real spread = leap.spread[arc.pid];
+            if (drift > 0.0)
+            {
+                tau = std::min(tau, bound / drift);
+            }
+            if (spread > 0.0)
+            {
+                tau = std::min(tau, bound * bound / spread);
+            }
+        }
+    }
+    for (uint i = 0; i < n; i++)
+    {
+        for (const auto& c : model.changes[leap.timedEnabled[i]])
+        {
+            leap.drift[c.pid] = 0.0;
+            leap.spread[c.pid] = 0.0;
+        }
+    }
+    return tau;
+}
+
+// an index of timedEnabled among the selected ones, picked with
+// probability proportional to the propensities; x is uniform on [0, sum of
+// the selected propensities)
+template <typename Selected>
+static uint pickEnabled(const GpnTauLeapState& leap, Real x,
+                        const Selected& selected)
+{
+    uint last = 0;
+    for (uint i = 0; i < leap.timedEnabled.size(); i++)
+    {
+        if (!selected(i))
+        {
+            continue;
+        }
+        last = i;
+        x -= leap.propensities[i];
+        if (x < 0.0)
+        {
+            break;
+        }
+    }
+    return last;
+}
+
+// Draws the firings of a leap of length tau into leap.firings and
+// leap.delta. Returns false, leaving both cleared, if the leap empties a
+// place or its last firing of a transition would find an input arc short
+// of tokens or an inhibitor arc blocking.
+static bool drawLeap(const TauLeapModel& model, GpnSimState& state, Real tau,
+                     bool fire_critical, Real critical_sum,
+                     const std::vector<bool>& critical)
+{
+    auto& leap = state.tauLeap;
+    const MarkingIntf* mk = state.currMarking.get();
+    uint n = leap.timedEnabled.size();
+    for (uint i = 0; i < n; i++)
+    {
+        if (!critical[i])
+        {
+            leap.firings[leap.timedEnabled[i]] =
+                poissonSample(leap.propensities[i] * tau,
+                              state.uniformSampler);
+        }
+    }
+    if (fire_critical)
+    {
+        uint i = pickEnabled(leap, state.uniformSampler() * critical_sum,
+                             [&](uint j) { return critical[j]; });
+        leap.firings[leap.timedEnabled[i]] = 1;
+    }
+    for (uint i = 0; i < n; i++)
+    {
+        uint tid = leap.timedEnabled[i];
+        for (const auto& c : model.changes[tid])
+        {
+            leap.delta[c.pid] += c.tokens * leap.firings[tid];
+        }
+    }
+    bool valid = true;
+    for (uint i = 0; i < n && valid; i++)
+    {
+        uint tid = leap.timedEnabled[i];
+        for (const auto& c : model.changes[tid])
+        {
+            valid = valid &&
+                    (long long)mk->nToken(c.pid) + leap.delta[c.pid] >= 0;
+        }
+        if (leap.firings[tid] == 0)
+        {
+            continue;
+        }
+        for (const auto& arc : model.inhibitors[tid])
+        {
+            // tokens before the last firing of tid
+            long long before = (long long)mk->nToken(arc.pid) +
+                               leap.delta[arc.pid] -
+                               placeChange(model, tid, arc.pid);
+            valid = valid && before < arc.multi;
+        }
+        for (const auto& arc : model.inputs[tid])
+        {
+            // tokens before the last firing of tid
+            long long before = (long long)mk->nToken(arc.pid) +
+                               leap.delta[arc.pid] -
+                               placeChange(model, tid, arc.pid);
+            valid = valid && before >= arc.multi;
+        }
+    }
+    if (!valid)
+    {
+        for (uint i = 0; i < n; i++)
+        {
+            uint tid = leap.timedEnabled[i];
+            leap.firings[tid] = 0;
+            for (const auto& c : model.changes[tid])
+            {
+                leap.delta[c.pid] = 0;
+            }
+        }
+    }
+    return valid;
+}
+
+// schedules the next exact firing or leap from the current marking
+static void scheduleNextStep(const TauLeapModel& model, GpnSimState& state,
+                             GpnSimulator::EventQueue& queue, Real now)
+{
+    const MarkingIntf* mk = state.currMarking.get();
+    state.net.enabledTransitions(mk, state.enabledTrans);
+    if (isVanMarking(state.net, state.enabledTrans))
+    {
+        uint next_tid = chooseFiringImmeTrans(state.net, mk,
+                                              state.enabledTrans,
+                                              state.uniformSampler(),
+                                              state.weights);
+        queue.schedule(now, next_tid);
+        return;
+    }
+    auto& leap = state.tauLeap;
+    leap.timedEnabled = state.enabledTrans;
+    uint n = leap.timedEnabled.size();
+    leap.propensities.resize(n);
+    Real total = 0.0;
+    for (uint i = 0; i < n; i++)
+    {
+        uint tid = leap.timedEnabled[i];
+        leap.propensities[i] = model.rates[tid]({&state.net, mk});
+        total += leap.propensities[i];
+    }
+    if (total <= 0.0)
+    {
+        return;
+    }
+    auto& critical = leap.critical;
+    critical.resize(n);
+    Real critical_sum = 0.0;
+    for (uint i = 0; i < n; i++)
+    {
+        critical[i] = firingLimit(model, leap.timedEnabled[i], mk) <
+                      model.options.criticalFirings;
+        if (critical[i])
+        {
+            critical_sum += leap.propensities[i];
+        }
+    }
+    Real tau1 = noncriticalTau(model, leap, critical, mk);
+    Real exact_below = model.options.exactStepFactor / total;
+    while (tau1 >= exact_below)
+    {
+        Real tau2 = critical_sum > 0.0
+                        ? -std::log(state.uniformSampler()) / critical_sum
+                        : INFINITY;
+        Real tau = std::min(tau1, tau2);
+        if (std::isinf(tau))
+        {
+            break;
+        }
+        if (drawLeap(model, state, tau, tau2 <= tau1, critical_sum,
+                     critical))
+        {
+            for (uint tid : leap.timedEnabled)
+            {
+                leap.stats.leapFirings += leap.firings[tid];
+                leap.firings[tid] = 0;
+            }
+            leap.stats.leaps++;
+            leap.stats.minTau = std::min(leap.stats.minTau, tau);
+            leap.stats.maxTau = std::max(leap.stats.maxTau, tau);
+            queue.schedule(now + tau, state.net.transCount());
+            return;
+        }
+        leap.stats.rejections++;
+        tau1 /= 2;
+    }
+    leap.stats.exactSteps++;
+    Real delay = -std::log(state.uniformSampler()) / total;
+    uint i = pickEnabled(leap, state.uniformSampler() * total,
+                         [](uint) { return true; });
+    queue.schedule(now + delay, leap.timedEnabled[i]);
+}
+
+static void tauLeapHandlers(GpnSimulator& sim, GpnTauLeapOptions options)
+{
+    auto model = tauLeapModel(sim.state().net, options);
+    sim.handler(EventType::Begin, [model](GpnSimulator::Event evt,
+                                          GpnSimulator::State& state,
+                                          GpnSimulator::EventQueue& queue) {
+        resetMarking(state);
+        auto& leap = state.tauLeap;
+        leap.firings.assign(state.net.transCount(), 0);
+        leap.delta.assign(state.net.placeCount(), 0);
+        leap.drift.assign(state.net.placeCount(), 0.0);
+        leap.spread.assign(state.net.placeCount(), 0.0);
+        scheduleNextStep(*model, state, queue, evt.time);
+    });
+    sim.handler(EventType::User, [model](GpnSimulator::Event evt,
+                                         GpnSimulator::State& state,
+                                         GpnSimulator::EventQueue& queue) {
+        if (evt.data == state.net.transCount())
+        {  // the end of a leap
+            auto& delta = state.tauLeap.delta;
+            for (uint pid = 0; pid < delta.size(); pid++)
+            {
+                if (delta[pid] != 0)
+                {
+                    state.currMarking->setToken(
+                        pid, state.currMarking->nToken(pid) + delta[pid]);
+                    delta[pid] = 0;
+                }
+            }
+        }
+        else
+        {
+            state.net.fireTransitionInPlace(evt.data, *state.currMarking);
+        }
+        scheduleNextStep(*model, state, queue, evt.time);
+    });
+}
+
+GpnSimulator gpnTauLeapSimulator(GeneralPetriNet net,
+                                 const MarkingIntf& init_mk,
+                                 std::function<Real()> uniform_sampler,
+                                 GpnTauLeapOptions options)
+{
+    if (!gpnTauLeapApplies(net))
+    {
+        throw std::invalid_argument(
+            "Tau-leaping needs exponential timed transitions of one priority "
+            "below every immediate transition and constant arc "
+            "multiplicities.");
+    }
+    GpnSimulator sim(
+        GpnSimState(std::move(net), init_mk, std::move(uniform_sampler)));
+    tauLeapHandlers(sim, options);
+    return sim;
 }
 
 using namespace simulate;
 GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
-                          std::function<Real()> uniform_sampler)
+                          std::function<Real()> uniform_sampler,
+                          GpnEngine engine)
 {
+    if (engine == GpnEngine::DirectMethod && !gpnDirectMethodApplies(net))
+    {
+        throw std::invalid_argument(
+            "The direct method needs exponential timed transitions of one "
+            "priority below every immediate transition.");
+    }
+    if (engine == GpnEngine::Auto)
+    {
+        engine = gpnDirectMethodApplies(net) ? GpnEngine::DirectMethod
+                                             : GpnEngine::EventQueue;
+    }
     GpnSimulator sim(
         GpnSimState(std::move(net), init_mk, std::move(uniform_sampler)));
+    if (engine == GpnEngine::DirectMethod)
+    {
+        directMethodHandlers(sim);
+        return sim;
+    }
     sim.handler(EventType::Begin, [](GpnSimulator::Event evt,
                                      GpnSimulator::State& state,
                                      GpnSimulator::EventQueue& queue) {
-        state.currMarking = state.initMarking->clone();
-        state.remainingTime = std::vector<Real>(state.net.transCount(), -1.0);
-        state.enabledTrans =
-            state.net.enabledTransitions(state.currMarking.get());
+        resetMarking(state);
+        state.remainingTime.assign(state.net.transCount(), -1.0);
+        state.transEvents.assign(state.net.transCount(), EventHandle{0, 0});
+        state.net.enabledTransitions(state.currMarking.get(),
+                                     state.enabledTrans);
 
         const auto& enabled_tids = state.enabledTrans;
         bool van = isVanMarking(state.net, enabled_tids);
         if (van)
         {
-            uint next_tid =
-                chooseFiringImmeTrans(state.net, state.currMarking.get(),
-                                      enabled_tids, state.uniformSampler());
+            uint next_tid = chooseFiringImmeTrans(
+                state.net, state.currMarking.get(), enabled_tids,
+                state.uniformSampler(), state.weights);
             queue.schedule(evt.time, next_tid);
         }
         else
@@ -133,7 +806,7 @@ GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
                     evt.time + state.net.transProps[tid].timed.sampler(
                                    {&state.net, state.currMarking.get()},
                                    state.uniformSampler);
-                queue.schedule(evt_time, tid);
+                state.transEvents[tid] = queue.schedule(evt_time, tid);
             }
         }
     });
@@ -141,13 +814,13 @@ GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
     sim.handler(EventType::User, [](GpnSimulator::Event evt,
                                     GpnSimulator::State& state,
                                     GpnSimulator::EventQueue& queue) {
-        auto prev_enabled = state.enabledTrans;
+        std::swap(state.prevEnabled, state.enabledTrans);
+        auto& prev_enabled = state.prevEnabled;
         uint firing_tid = evt.data;
-        state.currMarking =
-            state.net.fireTransition(firing_tid, state.currMarking.get());
+        state.net.fireTransitionInPlace(firing_tid, *state.currMarking);
         state.remainingTime[firing_tid] = -1.0;
-        state.enabledTrans =
-            state.net.enabledTransitions(state.currMarking.get());
+        state.net.enabledTransitions(state.currMarking.get(),
+                                     state.enabledTrans);
         auto& curr_enabled = state.enabledTrans;
 
         bool prev_van = isVanMarking(state.net, prev_enabled);
@@ -160,7 +833,7 @@ GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
                 // van -> van
                 uint next_tid = chooseFiringImmeTrans(
                     state.net, state.currMarking.get(), curr_enabled,
-                    state.uniformSampler());
+                    state.uniformSampler(), state.weights);
                 queue.schedule(evt.time, next_tid);
             }
             else
@@ -190,7 +863,7 @@ GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
                                        {&state.net, state.currMarking.get()},
                                        state.uniformSampler);
                     }
-                    queue.schedule(evt_time, tid);
+                    state.transEvents[tid] = queue.schedule(evt_time, tid);
                 }
             }
         }
@@ -213,11 +886,8 @@ GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
                     assert(tp.type == GpnTransType::Timed);
                     // remove scheduled events
                     GpnSimulator::Event rm_evt;
-                    bool removed = queue.removeFirst(
-                        [=](GpnSimulator::Event evt) {
-                            return evt.data == tid;
-                        },
-                        &rm_evt);
+                    bool removed =
+                        queue.cancel(state.transEvents[tid], &rm_evt);
                     assert(removed);
 
                     // save remaining time
@@ -232,25 +902,24 @@ GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
                 }
                 uint next_tid = chooseFiringImmeTrans(
                     state.net, state.currMarking.get(), curr_enabled,
-                    state.uniformSampler());
+                    state.uniformSampler(), state.weights);
                 queue.schedule(evt.time, next_tid);
             }
             else
             {
                 // tan -> tan
-                auto disabled2enabled = setSub(curr_enabled, prev_enabled);
-                auto enabled2disabled = setSub(prev_enabled, curr_enabled);
+                auto& disabled2enabled = state.newlyEnabled;
+                auto& enabled2disabled = state.newlyDisabled;
+                setSub(curr_enabled, prev_enabled, disabled2enabled);
+                setSub(prev_enabled, curr_enabled, enabled2disabled);
                 for (uint tid : enabled2disabled)
                 {
                     const auto& tp = state.net.transProps[tid];
                     assert(tp.type == GpnTransType::Timed);
                     // remove scheduled events
                     GpnSimulator::Event rm_evt;
-                    bool removed = queue.removeFirst(
-                        [=](GpnSimulator::Event evt) {
-                            return evt.data == tid;
-                        },
-                        &rm_evt);
+                    bool removed =
+                        queue.cancel(state.transEvents[tid], &rm_evt);
                     assert(removed);
 
                     // save remaining time
@@ -288,7 +957,7 @@ GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
                                        {&state.net, state.currMarking.get()},
                                        state.uniformSampler);
                     }
-                    queue.schedule(evt_time, tid);
+                    state.transEvents[tid] = queue.schedule(evt_time, tid);
                 }
             }
         }
@@ -297,4 +966,22 @@ GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
     return sim;
 }
 
+void gpnReseed(GpnSimulator& sim, std::uint64_t seed, std::uint64_t stream)
+{
+    sim.state().uniformSampler = BufferedSampler(seed, stream);
+}
+
+SplittingResult gpnSplitting(const GpnSimulator& sim,
+                             MarkingDepReal importance,
+                             const std::vector<Real>& levels, Real horizon,
+                             const SplittingOptions& options,
+                             std::uint64_t seed, uint nthread)
+{
+    auto marking_importance = [&](const GpnSimState& state) {
+        return importance({&state.net, state.currMarking.get()});
+    };
+    return fixedEffortSplitting(sim, marking_importance, levels, horizon,
+                                options, seed, nthread, gpnReseed);
+}
+
 }  // namespace sanity::petrinet
@@ -1,4 +1,6 @@
 #pragma once
+#include <cmath>
+#include <cstdint>
 #include <functional>
 #include "gpn.hpp"
 #include "petrinet.hpp"
@@ -6,6 +8,45 @@
 
 namespace sanity::petrinet
 {
+// the error controls of tau-leaping, see gpnTauLeapSimulator
+struct GpnTauLeapOptions
+{
+    // bound on the relative change of the token count of an input place
+    // of a leaping transition over one leap
+    Real epsilon = 0.03;
+    // transitions that can fire fewer times than this before disabling
+    // themselves are critical and fire at most once per leap
+    uint criticalFirings = 10;
+    // exact steps are taken while leaps would be shorter than this many
+    // mean exact steps
+    Real exactStepFactor = 10.0;
+};
+
+struct GpnTauLeapStats
+{
+    std::uint64_t leaps = 0;
+    std::uint64_t leapFirings = 0;  // firings done by leaps
+    std::uint64_t exactSteps = 0;
+    // leaps drawn again with a halved step, because they emptied a place
+    // or overran an input or inhibitor arc
+    std::uint64_t rejections = 0;
+    Real minTau = INFINITY;
+    Real maxTau = 0.0;
+};
+
+struct GpnTauLeapState
+{
+    GpnTauLeapStats stats;
+    // scratch buffers of the leap in preparation
+    std::vector<uint> firings;       // by transition
+    std::vector<long long> delta;    // token change by place
+    std::vector<Real> drift;         // expected token change by place
+    std::vector<Real> spread;        // variance of the change by place
+    std::vector<uint> timedEnabled;  // enabled timed transitions
+    std::vector<Real> propensities;  // of timedEnabled
+    std::vector<bool> critical;      // of timedEnabled
+};
+
 struct GpnSimState
 {
     // const part
@@ -16,6 +57,24 @@ struct GpnSimState
     std::unique_ptr<MarkingIntf> currMarking;
     std::vector<uint> enabledTrans;
     std::vector<Real> remainingTime;  // for transitions with resume policy
+    // the pending firing event of every enabled timed transition
+    std::vector<simulate::EventHandle> transEvents;
+
+    // scratch buffers of the event handlers, kept so that their storage is
+    // reused from event to event
+    std::vector<uint> prevEnabled;
+    std::vector<uint> newlyEnabled;
+    std::vector<uint> newlyDisabled;
+    std::vector<Real> weights;
+
+    // direct method only, which in turn leaves enabledTrans and transEvents
+    // alone: the rates of the timed transitions (0 if disabled) and which
+    // immediate transitions are enabled
+    simulate::SumTree timedRates;
+    std::vector<bool> immEnabled;
+    uint immEnabledCount;
+
+    GpnTauLeapState tauLeap;  // tau-leaping only
 
     GpnSimState(GeneralPetriNet net, const MarkingIntf& marking,
                 std::function<Real()> usampler)
@@ -24,14 +83,107 @@ struct GpnSimState
           uniformSampler(std::move(usampler)),
           currMarking(),
           enabledTrans(),
-          remainingTime()
+          remainingTime(),
+          transEvents(),
+          prevEnabled(),
+          newlyEnabled(),
+          newlyDisabled(),
+          weights(),
+          timedRates(),
+          immEnabled(),
+          immEnabledCount(0),
+          tauLeap()
     {
     }
+    GpnSimState(const GpnSimState& other)
+        : net(other.net),
+          initMarking(other.initMarking->clone()),
+          uniformSampler(other.uniformSampler),
+          currMarking(other.currMarking ? other.currMarking->clone()
+                                        : nullptr),
+          enabledTrans(other.enabledTrans),
+          remainingTime(other.remainingTime),
+          transEvents(other.transEvents),
+          prevEnabled(other.prevEnabled),
+          newlyEnabled(other.newlyEnabled),
+          newlyDisabled(other.newlyDisabled),
+          weights(other.weights),
+          timedRates(other.timedRates),
+          immEnabled(other.immEnabled),
+          immEnabledCount(other.immEnabledCount),
+          tauLeap(other.tauLeap)
+    {
+    }
+    GpnSimState(GpnSimState&&) = default;
+    GpnSimState& operator=(const GpnSimState& other)
+    {
+        *this = GpnSimState(other);
+        return *this;
+    }
+    GpnSimState& operator=(GpnSimState&&) = default;
 };
 
 using GpnSimulator = simulate::SimulatorT<uint, GpnSimState>;
 
+enum class GpnEngine
+{
+    // DirectMethod if the net qualifies, EventQueue otherwise
+    Auto,
+    // one pending event per enabled timed transition, any distribution
+    EventQueue,
+    // Gillespie's direct method: one pending event for the next firing,
+    // drawn from the total rate of the enabled transitions
+    DirectMethod
+};
+
+// Whether the direct method can simulate net: every timed transition is
+// exponential with a constant rate (its sample policy is then irrelevant),
+// all of them share one priority and every immediate transition has a
+// higher one. Marking dependent rates are excluded because the event queue
+// engine only evaluates them when a transition gets enabled.
+bool gpnDirectMethodApplies(const GeneralPetriNet& net);
+
+// throws std::invalid_argument if the direct method is asked for but does
+// not apply
 GpnSimulator gpnSimulator(GeneralPetriNet net, const MarkingIntf& init_mk,
-                          std::function<Real()> uniform_sampler);
+                          std::function<Real()> uniform_sampler,
+                          GpnEngine engine = GpnEngine::Auto);
+
+// Whether gpnTauLeapSimulator can simulate net: as gpnDirectMethodApplies,
+// except that rates may depend on the marking, and all arc multiplicities
+// are constant.
+bool gpnTauLeapApplies(const GeneralPetriNet& net);
+
+// Approximate simulation by tau-leaping (Cao, Gillespie and Petzold,
+// "Efficient step size selection for the tau-leaping simulation method").
+// Every leap of length tau fires each enabled noncritical transition a
+// Poisson(rate * tau) number of times and at most one critical transition,
+// all in a single event at the end of the leap, so that observers see the
+// marking change in one step. tau keeps the expected change of every input
+// place within options.epsilon of its token count (or one token). Near
+// zero tokens, and whenever leaps would be too short, exact direct method
+// steps are taken instead. Unlike the event queue engine, rates are
+// evaluated in the current marking, as in the CTMC of the net. Immediate
+// transitions and enabling functions are only checked between leaps.
+// Statistics accumulate in the state's tauLeap.stats. Throws
+// std::invalid_argument if the net does not qualify.
+GpnSimulator gpnTauLeapSimulator(GeneralPetriNet net,
+                                 const MarkingIntf& init_mk,
+                                 std::function<Real()> uniform_sampler,
+                                 GpnTauLeapOptions options = {});
+
+// gives the simulator a buffered Philox sampler on the given stream, e.g. as
+// the reseed function of simulate::runReplications
+void gpnReseed(GpnSimulator& sim, std::uint64_t seed, std::uint64_t stream);
+
+// The probability that the importance of the marking reaches levels.back()
+// within horizon time units, by simulate::fixedEffortSplitting with every
+// trajectory reseeded by gpnReseed. Suits rare failures when importance
+// counts, e.g., the failed components.
+simulate::SplittingResult gpnSplitting(
+    const GpnSimulator& sim, MarkingDepReal importance,
+    const std::vector<Real>& levels, Real horizon,
+    const simulate::SplittingOptions& options, std::uint64_t seed,
+    uint nthread = 0);
 
 }  // namespace sanity::petrinet
@@ -1,5 +1,8 @@
 #pragma once
+#include <cstdint>
 #include <memory>
+#include <string_view>
+#include <sys/types.h>
 #include <vector>
 
 namespace sanity::petrinet
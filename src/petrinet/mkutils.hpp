@@ -26,7 +26,7 @@ using MarkingMap =
 
 int findMarking(MarkingMap& mk_map, const MarkingIntf* newmk);
 
-uint addNewMarking(graph::DiGraph& graph, MarkingMap& mk_map,
+uint addNewMarking(graph::CsrDiGraph& graph, MarkingMap& mk_map,
                    std::vector<std::unique_ptr<MarkingIntf>>& markings,
                    std::unique_ptr<MarkingIntf> newmk);
 
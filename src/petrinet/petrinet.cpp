@@ -1,4 +1,5 @@
 #include "petrinet.hpp"
+#include <algorithm>
 #include <cassert>
 namespace sanity::petrinet
 {
@@ -67,22 +68,29 @@ std::vector<uint> PetriNet::enabledTransitions(const MarkingIntf* mk) const
 {
     auto etrans = std::vector<uint>();
     etrans.reserve(transCount());
+    enabledTransitions(mk, etrans);
+    return etrans;
+}
+
+void PetriNet::enabledTransitions(const MarkingIntf* mk,
+                                  std::vector<uint>& out) const
+{
+    out.clear();
     bool found_enabled = false;
     uint64_t enabled_prio;
     for (const auto& tr : _transitions)
     {
         if (found_enabled && enabled_prio > tr.prio)
         {
-            return etrans;
+            return;
         }
         if (isolateEnableCheck(tr, mk))
         {
-            etrans.push_back(tr.tid);
+            out.push_back(tr.tid);
             enabled_prio = tr.prio;
             found_enabled = true;
         }
     }
-    return etrans;
 }
 
 std::unique_ptr<MarkingIntf> PetriNet::fireTransition(
@@ -105,6 +113,34 @@ std::unique_ptr<MarkingIntf> PetriNet::fireTransition(
     return newmk;
 }
 
+void PetriNet::fireTransitionInPlace(uint tid, MarkingIntf& mk) const
+{
+    const auto& tr = getTransition(tid);
+    auto dep = [](const Arc& arc) { return arc.multi.markingDependent(); };
+    if (std::any_of(tr.inputArcs.begin(), tr.inputArcs.end(), dep) ||
+        std::any_of(tr.outputArcs.begin(), tr.outputArcs.end(), dep))
+    {
+        auto newmk = fireTransition(tid, &mk);
+        for (uint pid = 0; pid < mk.size(); pid++)
+        {
+            mk.setToken(pid, newmk->nToken(pid));
+        }
+        return;
+    }
+    auto state = PetriNetState{this, &mk};
+    for (const auto& arc : tr.inputArcs)
+    {
+        auto multi = arc.multi(state);
+        assert(mk.nToken(arc.pid) >= multi);
+        mk.setToken(arc.pid, mk.nToken(arc.pid) - multi);
+    }
+    for (const auto& arc : tr.outputArcs)
+    {
+        auto multi = arc.multi(state);
+        mk.setToken(arc.pid, mk.nToken(arc.pid) + multi);
+    }
+}
+
 bool PetriNet::isTransitionEnabled(uint tid, const MarkingIntf* mk) const
 {
     bool found_enabled = false;
@@ -39,6 +39,7 @@ public:
             return _val;
         }
     }
+    bool markingDependent() const { return (bool)_func; }
 
 private:
     ReturnType _val;
@@ -68,6 +69,7 @@ public:
             return _val;
         }
     }
+    bool markingDependent() const { return (bool)_func; }
 
 private:
     ReturnType _val;
@@ -97,6 +99,7 @@ public:
             return _val;
         }
     }
+    bool markingDependent() const { return (bool)_func; }
 
 private:
     ReturnType _val;
@@ -138,10 +141,23 @@ public:
     uint transCount() const { return _transitions.size(); }
     uint placeCount() const { return _place_count; }
     std::vector<uint> enabledTransitions(const MarkingIntf* mk) const;
+    // same as above, reusing the storage of out
+    void enabledTransitions(const MarkingIntf* mk,
+                            std::vector<uint>& out) const;
     int firstEanbledTrans(const MarkingIntf* mk) const;
     bool isTransitionEnabled(uint tid, const MarkingIntf* mk) const;
+    // whether tid is enabled if the priorities of the others are ignored
+    bool isTransitionEnabledIsolated(uint tid, const MarkingIntf* mk) const
+    {
+        return isolateEnableCheck(getTransition(tid), mk);
+    }
+    const MarkingDepBool& globalEnabling() const { return _global_enabling; }
     std::unique_ptr<MarkingIntf> fireTransition(uint tid,
                                                 const MarkingIntf* mk) const;
+    // Fires tid on mk itself. Arc multiplicities are evaluated on the
+    // marking before the firing, which takes a temporary copy only if some
+    // arc of tid is marking dependent.
+    void fireTransitionInPlace(uint tid, MarkingIntf& mk) const;
 
 private:
     bool isolateEnableCheck(const Transition& tr,
@@ -10,7 +10,7 @@ using namespace linear;
 
 ReachGraph genReachGraph(const PetriNet& net, const MarkingIntf& mk)
 {
-    DiGraph graph;
+    CsrDiGraph graph;
     std::vector<std::unique_ptr<MarkingIntf>> markings;
     std::vector<uint> edge2trans;
     MarkingMap mk_map;
@@ -8,7 +8,7 @@ namespace sanity::petrinet
 {
 struct ReachGraph
 {
-    graph::DiGraph graph;
+    graph::CsrDiGraph graph;
     std::vector<std::unique_ptr<MarkingIntf>> nodeMarkings;
     std::vector<uint> edgeTrans;
 };
@@ -0,0 +1,48 @@
+#include "srncache.hpp"
+#include <algorithm>
+
+namespace sanity::petrinet
+{
+using namespace linear;
+
+Vector SrnSolutionCache::initialGuess(std::uint64_t key, uint n) const
+{
+    auto it = _entries.find(key);
+    if (it == _entries.end() || it->second.last.size() != n)
+    {
+        return Vector(n, 1.0);
+    }
+    const auto& entry = it->second;
+    if (_guess == Guess::Previous || entry.prev.size() != n)
+    {
+        return entry.last;
+    }
+    Vector x(n);
+    for (uint i = 0; i < n; i++)
+    {
+        x(i) = std::max(0.0, 2.0 * entry.last(i) - entry.prev(i));
+    }
+    Real norm = norm1(x);
+    if (norm <= 0.0)
+    {
+        return entry.last;
+    }
+    scale(norm1(entry.last) / norm, mutableView(x));
+    return x;
+}
+
+void SrnSolutionCache::store(std::uint64_t key, VectorConstView solution)
+{
+    auto& entry = _entries[key];
+    if (entry.last.size() == solution.size())
+    {
+        entry.prev = std::move(entry.last);
+    }
+    else
+    {
+        entry.prev = Vector();
+    }
+    entry.last = Vector(solution);
+}
+
+}  // namespace sanity::petrinet
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include "graph.hpp"
+#include "linear.hpp"
+#include "type.hpp"
+
+namespace sanity::petrinet
+{
+// Initial guesses for repeated steady state solves of the same reachability
+// graph, e.g. in a parameter sweep. Solutions are kept per key, normally
+// graph::structuralHash of the reachability graph. The guess is either the
+// last stored solution or the linear extrapolation 2 * x1 - x0 of the last
+// two, which assumes evenly spaced sweep points. Extrapolated entries are
+// clipped at zero and the result is scaled to the norm of the last
+// solution.
+class SrnSolutionCache
+{
+public:
+    enum class Guess
+    {
+        Previous,
+        Extrapolate
+    };
+
+    SrnSolutionCache(Guess guess = Guess::Extrapolate) : _guess(guess) {}
+
+    // a vector of ones (the usual cold start) if nothing of size n is
+    // stored under key
+    linear::Vector initialGuess(std::uint64_t key, uint n) const;
+    void store(std::uint64_t key, linear::VectorConstView solution);
+    bool contains(std::uint64_t key) const
+    {
+        return _entries.find(key) != _entries.end();
+    }
+    void erase(std::uint64_t key) { _entries.erase(key); }
+    void clear() { _entries.clear(); }
+    uint size() const { return _entries.size(); }
+
+private:
+    struct Entry
+    {
+        linear::Vector last;
+        linear::Vector prev;  // empty until two solutions are stored
+    };
+    Guess _guess;
+    std::unordered_map<std::uint64_t, Entry> _entries;
+};
+
+}  // namespace sanity::petrinet
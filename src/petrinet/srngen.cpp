@@ -0,0 +1,308 @@
+#include "srngen.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string_view>
+
+namespace sanity::petrinet
+{
+using namespace linear;
+
+static bool isTangible(const StochasticRewardNet& srn, const MarkingIntf* mk)
+{
+    int tid = srn.firstEanbledTrans(mk);
+    return tid < 0 ||
+           srn.transProps[(uint)tid].type == SrnTransType::Exponetial;
+}
+
+SrnGenerator::SrnGenerator(const StochasticRewardNet& srn,
+                           const MarkingIntf& init)
+    : _srn(&srn),
+      _init(init.clone()),
+      _nplace(init.size()),
+      _nstate(0),
+      _tokens(),
+      _table(16, emptySlot),
+      _diag()
+{
+    auto mk = init.clone();
+    std::vector<Token> key(_nplace);
+    std::vector<Token> src(_nplace);
+    for (uint pid = 0; pid < _nplace; pid++)
+    {
+        key[pid] = init.nToken(pid);
+    }
+    add(key.data());
+    std::vector<uint> enabled;
+    std::vector<Real> exit_rates;
+    for (uint curr = 0; curr < _nstate; curr++)
+    {
+        load(curr, *mk, key, src);
+        if (!isTangible(srn, mk.get()))
+        {
+            throw std::invalid_argument(
+                "SrnGenerator does not support immediate transitions.");
+        }
+        Real exit_rate = 0.0;
+        srn.enabledTransitions(mk.get(), enabled);
+        for (uint tid : enabled)
+        {
+            Real rate = srn.transProps[tid].val({&srn, mk.get()});
+            fire(tid, *mk, key);
+            int dst = lookup(key.data());
+            if (dst < 0)
+            {
+                dst = (int)add(key.data());
+            }
+            if ((uint)dst != curr)
+            {
+                exit_rate += rate;
+            }
+            restore(tid, *mk, key, src);
+        }
+        exit_rates.push_back(exit_rate);
+    }
+    _diag = Vector(exit_rates.size());
+    for (uint i = 0; i < exit_rates.size(); i++)
+    {
+        _diag(i) = -exit_rates[i];
+    }
+}
+
+std::size_t SrnGenerator::hash(const Token* tokens) const
+{
+    std::string_view sview((const char*)tokens, sizeof(Token) * _nplace);
+    return std::hash<std::string_view>()(sview);
+}
+
+int SrnGenerator::lookup(const Token* tokens) const
+{
+    std::size_t mask = _table.size() - 1;
+    for (std::size_t pos = hash(tokens) & mask; _table[pos] != emptySlot;
+         pos = (pos + 1) & mask)
+    {
+        if (std::equal(tokens, tokens + _nplace, this->tokens(_table[pos])))
+        {
+            return (int)_table[pos];
+        }
+    }
+    return -1;
+}
+
+uint SrnGenerator::add(const Token* tokens)
+{
+    uint idx = _nstate++;
+    _tokens.insert(_tokens.end(), tokens, tokens + _nplace);
+    if (2 * (std::size_t)_nstate > _table.size())
+    {  // keep the load factor at most 1/2
+        _table.assign(2 * _table.size(), emptySlot);
+        for (uint i = 0; i < _nstate; i++)
+        {
+            std::size_t mask = _table.size() - 1;
+            std::size_t pos = hash(this->tokens(i)) & mask;
+            while (_table[pos] != emptySlot)
+            {
+                pos = (pos + 1) & mask;
+            }
+            _table[pos] = i;
+        }
+        return idx;
+    }
+    std::size_t mask = _table.size() - 1;
+    std::size_t pos = hash(tokens) & mask;
+    while (_table[pos] != emptySlot)
+    {
+        pos = (pos + 1) & mask;
+    }
+    _table[pos] = idx;
+    return idx;
+}
+
+void SrnGenerator::fire(uint tid, MarkingIntf& mk,
+                        std::vector<Token>& key) const
+{
+    _srn->fireTransitionInPlace(tid, mk);
+    const auto& tr = _srn->getTransition(tid);
+    for (const auto& arc : tr.inputArcs)
+    {
+        key[arc.pid] = mk.nToken(arc.pid);
+    }
+    for (const auto& arc : tr.outputArcs)
+    {
+        key[arc.pid] = mk.nToken(arc.pid);
+    }
+}
+
+void SrnGenerator::restore(uint tid, MarkingIntf& mk, std::vector<Token>& key,
+                           const std::vector<Token>& src) const
+{
+    const auto& tr = _srn->getTransition(tid);
+    for (const auto& arc : tr.inputArcs)
+    {
+        mk.setToken(arc.pid, src[arc.pid]);
+        key[arc.pid] = src[arc.pid];
+    }
+    for (const auto& arc : tr.outputArcs)
+    {
+        mk.setToken(arc.pid, src[arc.pid]);
+        key[arc.pid] = src[arc.pid];
+    }
+}
+
+void SrnGenerator::load(uint idx, MarkingIntf& mk, std::vector<Token>& key,
+                        std::vector<Token>& src) const
+{
+    const Token* t = tokens(idx);
+    for (uint pid = 0; pid < _nplace; pid++)
+    {
+        mk.setToken(pid, t[pid]);
+        key[pid] = t[pid];
+        src[pid] = t[pid];
+    }
+}
+
+std::unique_ptr<MarkingIntf> SrnGenerator::marking(uint idx) const
+{
+    assert(idx < _nstate);
+    auto mk = _init->clone();
+    const Token* t = tokens(idx);
+    for (uint pid = 0; pid < _nplace; pid++)
+    {
+        mk->setToken(pid, t[pid]);
+    }
+    return mk;
+}
+
+int SrnGenerator::find(const MarkingIntf* mk) const
+{
+    assert(mk->size() == _nplace);
+    std::vector<Token> key(_nplace);
+    for (uint pid = 0; pid < _nplace; pid++)
+    {
+        key[pid] = mk->nToken(pid);
+    }
+    return lookup(key.data());
+}
+
+void SrnGenerator::dotOffDiag(VectorConstView v, VectorMutableView x) const
+{
+    assert(v.size() == stateCount());
+    assert(x.size() == stateCount());
+    fill(0.0, x);
+    // scratch space shared by all the states
+    auto mk = _init->clone();
+    std::vector<Token> key(_nplace);
+    std::vector<Token> src(_nplace);
+    std::vector<uint> enabled;
+    enabled.reserve(_srn->transCount());
+    for (uint curr = 0; curr < stateCount(); curr++)
+    {
+        if (v(curr) == 0.0)
+        {
+            continue;
+        }
+        load(curr, *mk, key, src);
+        _srn->enabledTransitions(mk.get(), enabled);
+        for (uint tid : enabled)
+        {
+            Real rate = _srn->transProps[tid].val({_srn, mk.get()});
+            fire(tid, *mk, key);
+            int dst = lookup(key.data());
+            assert(dst >= 0);
+            if ((uint)dst != curr)
+            {
+                x((uint)dst) += rate * v(curr);
+            }
+            restore(tid, *mk, key, src);
+        }
+    }
+}
+
+void SrnGenerator::dot(VectorConstView v, VectorMutableView x) const
+{
+    dotOffDiag(v, x);
+    for (uint i = 0; i < stateCount(); i++)
+    {
+        x(i) += _diag(i) * v(i);
+    }
+}
+
+IterationResult srnSteadyStatePower(const SrnGeneratorIntf& Q,
+                                    VectorMutableView prob, Real tol,
+                                    uint max_iter, Real factor)
+{
+    assert(prob.size() == Q.stateCount());
+    assert(factor >= 1.0);
+    scale(1.0 / norm1(prob), prob);
+    Real error = 0.0;
+    uint iter = 0;
+    Real max_exit = 0.0;
+    auto diag = Q.diagonal();
+    for (uint i = 0; i < diag.size(); i++)
+    {
+        max_exit = std::max(max_exit, -diag(i));
+    }
+    if (max_exit == 0.0)
+    {  // nothing moves
+        return {.error = error, .nIter = iter};
+    }
+    Real unif = 1.0 / (factor * max_exit);
+    auto next_prob = Vector(prob.size());
+    for (iter = 1; iter <= max_iter; iter++)
+    {
+        // next = prob + Q prob / lambda
+        Q.dot(prob, mutableView(next_prob));
+        scale(unif, mutableView(next_prob));
+        blas::axpy(1.0, prob, mutableView(next_prob));
+        scale(1.0 / norm1(next_prob), mutableView(next_prob));
+        error = maxDiff(prob, next_prob);
+        copy(next_prob, prob);
+        if (error < tol)
+        {
+            break;
+        }
+    }
+    return {.error = error, .nIter = iter};
+}
+
+IterationResult srnSteadyStateJacobi(const SrnGeneratorIntf& Q,
+                                     VectorMutableView prob, Real w,
+                                     Real tol, uint max_iter)
+{
+    assert(prob.size() == Q.stateCount());
+    uint n = Q.stateCount();
+    auto diag = Q.diagonal();
+    for (uint i = 0; i < n; i++)
+    {
+        if (diag(i) == 0.0)
+        {
+            throw std::invalid_argument(
+                "Jacobi needs an irreducible chain, but a state has no "
+                "exits.");
+        }
+    }
+    scale(1.0 / norm1(prob), prob);
+    auto offdiag = Vector(n);
+    auto prob_prev = Vector(n);
+    Real error = NAN;
+    uint iter;
+    for (iter = 1; iter <= max_iter; iter++)
+    {
+        copy(prob, mutableView(prob_prev));
+        Q.dotOffDiag(prob_prev, mutableView(offdiag));
+        for (uint i = 0; i < n; i++)
+        {
+            prob(i) = w * (-offdiag(i) / diag(i)) + (1 - w) * prob_prev(i);
+        }
+        scale(1.0 / norm1(prob), prob);
+        error = maxDiff(prob, prob_prev);
+        if (error < tol)
+        {
+            break;
+        }
+    }
+    return {.error = error, .nIter = iter};
+}
+
+}  // namespace sanity::petrinet
@@ -0,0 +1,113 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "linear.hpp"
+#include "srn.hpp"
+#include "type.hpp"
+
+namespace sanity::petrinet
+{
+// A generator matrix (in the layout of srnRateMatrix) that is applied
+// without being stored
+class SrnGeneratorIntf
+{
+public:
+    virtual ~SrnGeneratorIntf() = default;
+    virtual uint stateCount() const = 0;
+    // minus the exit rates. self loops are not counted.
+    virtual linear::VectorConstView diagonal() const = 0;
+    // x = Q v
+    virtual void dot(linear::VectorConstView v,
+                     linear::VectorMutableView x) const = 0;
+    // x = (Q - diag(Q)) v
+    virtual void dotOffDiag(linear::VectorConstView v,
+                            linear::VectorMutableView x) const = 0;
+};
+
+// Generator matrix of an SRN that is never stored. Only the tangible
+// markings and their total exit rates are kept; every product fires the
+// enabled transitions of each marking again and looks the successors up.
+// This trades cpu time for memory, since the matrix of a large chain is
+// several times bigger than its markings.
+//
+// The markings are stored back to back in one token array and indexed by
+// an open addressing table of state indices, so a state costs its tokens
+// plus two table slots. A product fires every transition in place on one
+// scratch marking and then restores the places of its arcs, so it does not
+// allocate per state or per transition.
+//
+// The operator is the matrix of srnRateMatrix, i.e. x = Q v pushes
+// rate * v(src) from every state to its successors. Only nets without
+// immediate transitions are supported. The net must outlive the
+// generator.
+class SrnGenerator : public SrnGeneratorIntf
+{
+public:
+    // throws std::invalid_argument if an immediate transition is enabled in
+    // a reachable marking
+    SrnGenerator(const StochasticRewardNet& srn, const MarkingIntf& init);
+    SrnGenerator(const SrnGenerator&) = delete;
+    SrnGenerator& operator=(const SrnGenerator&) = delete;
+    SrnGenerator(SrnGenerator&&) = default;
+
+    virtual ~SrnGenerator() = default;
+    virtual uint stateCount() const override { return _nstate; }
+    // a copy of the marking of a state, of the same type as init
+    std::unique_ptr<MarkingIntf> marking(uint idx) const;
+    // index of a marking, -1 if it is not reachable
+    int find(const MarkingIntf* mk) const;
+    // bytes held for the markings and their index
+    std::size_t markingBytes() const
+    {
+        return _tokens.size() * sizeof(Token) + _table.size() * sizeof(uint);
+    }
+    virtual linear::VectorConstView diagonal() const override
+    {
+        return _diag;
+    }
+    virtual void dot(linear::VectorConstView v,
+                     linear::VectorMutableView x) const override;
+    virtual void dotOffDiag(linear::VectorConstView v,
+                            linear::VectorMutableView x) const override;
+
+private:
+    const StochasticRewardNet* _srn;
+    std::unique_ptr<MarkingIntf> _init;
+    uint _nplace;
+    uint _nstate;
+    std::vector<Token> _tokens;  // _nplace tokens per state
+    std::vector<uint> _table;    // state indices, emptySlot if unused
+    linear::Vector _diag;
+
+    static constexpr uint emptySlot = (uint)-1;
+    const Token* tokens(uint idx) const
+    {
+        return _tokens.data() + (std::size_t)idx * _nplace;
+    }
+    std::size_t hash(const Token* tokens) const;
+    int lookup(const Token* tokens) const;
+    uint add(const Token* tokens);
+    // fires tid on mk, whose tokens are also in key, and updates key
+    void fire(uint tid, MarkingIntf& mk, std::vector<Token>& key) const;
+    // undoes fire, src holds the tokens before the firing
+    void restore(uint tid, MarkingIntf& mk, std::vector<Token>& key,
+                 const std::vector<Token>& src) const;
+    // loads the tokens of a state into mk, key and src
+    void load(uint idx, MarkingIntf& mk, std::vector<Token>& key,
+              std::vector<Token>& src) const;
+};
+
+// Power method on the uniformized chain I + Q / (factor * max exit rate).
+// factor > 1 keeps the uniformized chain aperiodic.
+IterationResult srnSteadyStatePower(const SrnGeneratorIntf& Q,
+                                    linear::VectorMutableView prob, Real tol,
+                                    uint max_iter, Real factor = 1.02);
+
+// Jacobi method with relaxation w, only good for irreducible Markov chains.
+// Unlike SOR, a sweep only reads the previous iterate, so it can be done
+// with products of the operator.
+IterationResult srnSteadyStateJacobi(const SrnGeneratorIntf& Q,
+                                     linear::VectorMutableView prob, Real w,
+                                     Real tol, uint max_iter);
+
+}  // namespace sanity::petrinet
@@ -0,0 +1,159 @@
+#include "srnkron.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include "mkutils.hpp"
+
+namespace sanity::petrinet
+{
+using namespace linear;
+using namespace splinear;
+
+SrnKronComponent srnKronComponent(const StochasticRewardNet& srn,
+                                  const MarkingIntf& init,
+                                  const std::vector<uint>& sync_tids)
+{
+    struct Entry
+    {
+        uint src;
+        uint dst;
+        Real val;
+    };
+    std::vector<std::unique_ptr<MarkingIntf>> markings;
+    MarkingMap mk_map;
+    std::vector<Entry> local;
+    std::vector<std::vector<Entry>> sync(sync_tids.size());
+    auto add = [&](std::unique_ptr<MarkingIntf> mk) {
+        int tid = srn.firstEanbledTrans(mk.get());
+        if (tid >= 0 &&
+            srn.transProps[(uint)tid].type == SrnTransType::Immediate)
+        {
+            throw std::invalid_argument(
+                "srnKronComponent does not support immediate transitions.");
+        }
+        uint idx = markings.size();
+        mk_map[mk.get()] = idx;
+        markings.push_back(std::move(mk));
+        return idx;
+    };
+    add(init.clone());
+    for (uint curr = 0; curr < markings.size(); curr++)
+    {
+        const MarkingIntf* mk = markings[curr].get();
+        for (uint tid : srn.enabledTransitions(mk))
+        {
+            Real val = srn.transProps[tid].val({&srn, mk});
+            auto newmk = srn.fireTransition(tid, mk);
+            int dst = findMarking(mk_map, newmk.get());
+            if (dst < 0)
+            {
+                dst = (int)add(std::move(newmk));
+            }
+            auto s = std::find(sync_tids.begin(), sync_tids.end(), tid);
+            if (s == sync_tids.end())
+            {
+                local.push_back({curr, (uint)dst, val});
+            }
+            else
+            {
+                sync[(uint)(s - sync_tids.begin())].push_back(
+                    {curr, (uint)dst, val});
+            }
+        }
+    }
+
+    uint n = markings.size();
+    auto Q = SpmatrixCreator(n, n);
+    Q.reserve(2 * local.size());
+    for (const auto& e : local)
+    {
+        Q.addEntry(e.dst, e.src, e.val);
+        Q.addEntry(e.src, e.src, -e.val);
+    }
+    std::vector<Spmatrix> factors;
+    for (const auto& entries : sync)
+    {
+        auto W = SpmatrixCreator(n, n);
+        for (const auto& e : entries)
+        {
+            W.addEntry(e.dst, e.src, e.val);
+        }
+        factors.push_back(W.create(Spmatrix::RowCompressed));
+    }
+    return {.markings = std::move(markings),
+            .localGenerator = Q.create(Spmatrix::RowCompressed),
+            .syncFactors = std::move(factors)};
+}
+
+static std::vector<uint> matrixSizes(const std::vector<Spmatrix>& mats)
+{
+    std::vector<uint> sizes;
+    for (const auto& A : mats)
+    {
+        sizes.push_back(A.nrow);
+    }
+    return sizes;
+}
+
+SrnKronGenerator::SrnKronGenerator(std::vector<Spmatrix> local_generators)
+    : _desc(matrixSizes(local_generators)), _diag()
+{
+    for (uint c = 0; c < local_generators.size(); c++)
+    {
+        _desc.addLocal(c, std::move(local_generators[c]));
+    }
+    _diag = splinear::diagonal(_desc);
+}
+
+void SrnKronGenerator::addSync(Real rate, std::vector<KronFactor> factors)
+{
+    // the exit rate of a product state is the product of the column sums
+    KronTerm exits{-rate, {}};
+    for (const auto& f : factors)
+    {
+        uint n = f.matrix.nrow;
+        std::vector<Real> colsum(n, 0.0);
+        for (uint i = 0; i < n; i++)
+        {
+            for (uint k = f.matrix.ptr[i]; k < f.matrix.ptr[i + 1]; k++)
+            {
+                colsum[f.matrix.idx[k]] += f.matrix.val[k];
+            }
+        }
+        auto D = SpmatrixCreator(n, n);
+        for (uint i = 0; i < n; i++)
+        {
+            D.addEntry(i, i, colsum[i]);
+        }
+        exits.factors.push_back(
+            {f.component, D.create(Spmatrix::RowCompressed)});
+    }
+    _desc.addProduct(rate, std::move(factors));
+    _desc.addProduct(exits.scale, std::move(exits.factors));
+    std::vector<uint> sizes;
+    for (uint c = 0; c < _desc.componentCount(); c++)
+    {
+        sizes.push_back(_desc.componentSize(c));
+    }
+    // the transition itself touches the diagonal too, where every factor
+    // stays in the same local state
+    uint nterm = _desc.terms().size();
+    addDiagonal(_desc.terms()[nterm - 2], sizes, mutableView(_diag));
+    addDiagonal(_desc.terms()[nterm - 1], sizes, mutableView(_diag));
+}
+
+void SrnKronGenerator::dot(VectorConstView v, VectorMutableView x) const
+{
+    splinear::dot(_desc, v, x);
+}
+
+void SrnKronGenerator::dotOffDiag(VectorConstView v,
+                                  VectorMutableView x) const
+{
+    splinear::dot(_desc, v, x);
+    for (uint i = 0; i < stateCount(); i++)
+    {
+        x(i) -= _diag(i) * v(i);
+    }
+}
+
+}  // namespace sanity::petrinet
@@ -0,0 +1,65 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "linear.hpp"
+#include "splinear.hpp"
+#include "srn.hpp"
+#include "srngen.hpp"
+#include "type.hpp"
+
+namespace sanity::petrinet
+{
+// A submodel of a modular SRN. Its transitions are either local or the
+// submodel's part of a synchronizing transition.
+struct SrnKronComponent
+{
+    std::vector<std::unique_ptr<MarkingIntf>> markings;
+    splinear::Spmatrix localGenerator;  // layout of srnRateMatrix
+    // one per synchronizing transition, entry (dst, src) is the value
+    // (rate or weight) of the transition in marking src
+    std::vector<splinear::Spmatrix> syncFactors;
+};
+
+// Generates the local state space of a submodel from init, firing every
+// transition including the synchronizing ones (sync_tids). Throws
+// std::invalid_argument if an immediate transition is enabled.
+SrnKronComponent srnKronComponent(const StochasticRewardNet& srn,
+                                  const MarkingIntf& init,
+                                  const std::vector<uint>& sync_tids);
+
+// Generator of a modular SRN as a descriptor,
+//   Q = sum_c I x ... x Q_c x ... x I
+//       + sum_s rate_s * (W_s1 x ... x W_sN - diag(colsums)).
+// The state space is the product of the local ones, so it may contain
+// unreachable states; they only hold probability mass transiently, but a
+// state without exits makes the Jacobi method fail.
+class SrnKronGenerator : public SrnGeneratorIntf
+{
+public:
+    // one local generator per component, e.g.
+    // SrnKronComponent::localGenerator
+    explicit SrnKronGenerator(
+        std::vector<splinear::Spmatrix> local_generators);
+    virtual ~SrnKronGenerator() = default;
+
+    // a transition that moves every listed component at once with rate
+    // rate * W_1(dst_1, src_1) * ... * W_N(dst_N, src_N)
+    void addSync(Real rate, std::vector<splinear::KronFactor> factors);
+    const splinear::KronDescriptor& descriptor() const { return _desc; }
+
+    virtual uint stateCount() const override { return _desc.size(); }
+    virtual linear::VectorConstView diagonal() const override
+    {
+        return _diag;
+    }
+    virtual void dot(linear::VectorConstView v,
+                     linear::VectorMutableView x) const override;
+    virtual void dotOffDiag(linear::VectorConstView v,
+                            linear::VectorMutableView x) const override;
+
+private:
+    splinear::KronDescriptor _desc;
+    linear::Vector _diag;
+};
+
+}  // namespace sanity::petrinet
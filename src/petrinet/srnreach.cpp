@@ -40,7 +40,7 @@ struct MarkingListProb
     std::vector<Real> prob;
 };
 
-static Spmatrix srnProbMatrix(const DiGraph& reach_graph,
+static Spmatrix srnProbMatrix(const CsrDiGraph& reach_graph,
                               const std::vector<Real>& edge_probs)
 {
     const uint n = reach_graph.nodeCount();
@@ -69,7 +69,7 @@ MarkingListProb eliminateVanMarking(const StochasticRewardNet& srn,
                                     std::unique_ptr<MarkingIntf> vanmk,
                                     Real tol, uint max_iter)
 {
-    DiGraph graph;
+    CsrDiGraph graph;
     std::vector<std::unique_ptr<MarkingIntf>> node_markings;
     std::vector<Real> edge_probs;
     std::vector<uint> tan_mk_ids;
@@ -145,7 +145,7 @@ ReducedReachGenResult genReducedReachGraph(const StochasticRewardNet& srn,
     uint max_iter = 1000;
     Real tol = 1e-6;
 
-    DiGraph graph;
+    CsrDiGraph graph;
     std::vector<std::unique_ptr<MarkingIntf>> node_markings;
     std::vector<Real> edge_rates;
     std::vector<MarkingInitProb> init_probs;
@@ -15,7 +15,7 @@ struct MarkingInitProb
 
 struct ReducedReachGenResult
 {
-    graph::DiGraph graph;
+    graph::CsrDiGraph graph;
     std::vector<std::unique_ptr<MarkingIntf>> nodeMarkings;
     std::vector<Real> edgeRates;
     std::vector<MarkingInitProb> initProbs;
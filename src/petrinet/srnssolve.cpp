@@ -1,6 +1,9 @@
 #include "srnssolve.hpp"
+#include <algorithm>
+#include <cmath>
 #include "graph.hpp"
 #include "linear.hpp"
+#include "parallel.hpp"
 #include "splinear.hpp"
 #include "srnreach.hpp"
 
@@ -10,7 +13,7 @@ using namespace linear;
 using namespace splinear;
 using namespace graph;
 
-Spmatrix srnRateMatrix(const DiGraph& reach_graph,
+Spmatrix srnRateMatrix(const CsrDiGraph& reach_graph,
                        const std::vector<Real>& edge_rates)
 {
     const uint n = reach_graph.nodeCount();
@@ -29,17 +32,64 @@ Spmatrix srnRateMatrix(const DiGraph& reach_graph,
     return spmat.create(Spmatrix::RowCompressed);
 }
 
-IterationResult srnSteadyStateSor(const Spmatrix& Q, VectorMutableView prob,
-                                  Real w, Real tol, uint max_iter)
+Spmatrix srnRateMatrix(const CsrDiGraph& reach_graph,
+                       const std::vector<Real>& edge_rates,
+                       const Permutation& mat2node)
+{
+    const uint n = reach_graph.nodeCount();
+    auto spmat = SpmatrixCreator(n, n);
+    spmat.reserve(2 * reach_graph.edgeCount());
+    for (uint src = 0; src < n; src++)
+    {
+        int j = mat2node.backward(src);
+        assert(j >= 0);
+        for (const auto& edge : reach_graph.getNode(src).edges)
+        {
+            Real rate = edge_rates[edge.eid];
+            int i = mat2node.backward(edge.dst);
+            assert(i >= 0);
+            spmat.addEntry((uint)i, (uint)j, rate);
+            spmat.addEntry((uint)j, (uint)j, -rate);
+        }
+    }
+    return spmat.create(Spmatrix::RowCompressed);
+}
+
+// x *= a and returns max |x(i) - b * y(i)|, in one pass
+static Real scaleMaxDiff(Real a, VectorMutableView x, Real b,
+                         VectorConstView y)
+{
+    assert(x.size() == y.size());
+    Real error = 0.0;
+    for (uint i = 0; i < x.size(); i++)
+    {
+        x(i) *= a;
+        error = std::max(error, std::abs(x(i) - b * y(i)));
+    }
+    return error;
+}
+
+// Only every check_interval-th sweep normalizes prob and measures the
+// change. The sweeps are linear in prob, so the skipped normalizations
+// only change its scale. A checked sweep saves the old entries as it
+// overwrites them and sums both norms on the way, and one more pass
+// normalizes and compares.
+template <typename Matrix>
+static IterationResult steadyStateSor(const Matrix& Q, VectorMutableView prob,
+                                      Real w, Real tol, uint max_iter,
+                                      uint check_interval)
 {
     assert(Q.format == Spmatrix::RowCompressed);
+    assert(check_interval > 0);
     uint iter;
     Real error = NAN;
     scale(1.0 / norm1(prob), prob);
     auto prob_prev = Vector(prob.size());
     for (iter = 1; iter <= max_iter; iter++)
     {
-        copy(constView(prob), mutableView(prob_prev));
+        bool check = iter % check_interval == 0 || iter == max_iter;
+        Real prev_norm = 0.0;
+        Real norm = 0.0;
         for (uint i = 0; i < Q.nrow; i++)
         {
             auto iter = initRowIter(Q, i);
@@ -57,10 +107,20 @@ IterationResult srnSteadyStateSor(const Spmatrix& Q, VectorMutableView prob,
                 }
                 iter.nextNonzero();
             }
-            prob(i) = w * residual / a_ii + (1 - w) * prob(i);
+            Real old = prob(i);
+            if (check)
+            {
+                prob_prev(i) = old;
+                prev_norm += std::abs(old);
+            }
+            prob(i) = w * residual / a_ii + (1 - w) * old;
+            norm += std::abs(prob(i));
+        }
+        if (!check)
+        {
+            continue;
         }
-        scale(1.0 / norm1(prob), prob);
-        error = maxDiff(prob, prob_prev);
+        error = scaleMaxDiff(1.0 / norm, prob, 1.0 / prev_norm, prob_prev);
         if (error < tol)
         {
             break;
@@ -69,19 +129,114 @@ IterationResult srnSteadyStateSor(const Spmatrix& Q, VectorMutableView prob,
     return {.error = error, .nIter = iter};
 }
 
-SrnSteadyStateSol srnSteadyStateSor(const graph::DiGraph& rg,
-                                    const std::vector<Real>& edge_rates,
-                                    Real w, Real tol, uint max_iter)
+IterationResult srnSteadyStateSor(const Spmatrix& Q, VectorMutableView prob,
+                                  Real w, Real tol, uint max_iter,
+                                  uint check_interval)
+{
+    return steadyStateSor(Q, prob, w, tol, max_iter, check_interval);
+}
+
+IterationResult srnSteadyStateSor(const SpmatrixCompact& Q,
+                                  VectorMutableView prob, Real w, Real tol,
+                                  uint max_iter, uint check_interval)
+{
+    return steadyStateSor(Q, prob, w, tol, max_iter, check_interval);
+}
+
+SrnSorPlan srnSorPlan(const Spmatrix& Q, Real tol, uint arnoldi_steps)
+{
+    Real w = sorOptimalRelaxation(Q, arnoldi_steps);
+    Real rate = sorConvergenceRate(Q, w, arnoldi_steps);
+    if (w != 1.0)
+    {
+        Real gs_rate = sorConvergenceRate(Q, 1.0, arnoldi_steps);
+        if (gs_rate <= rate)
+        {
+            w = 1.0;
+            rate = gs_rate;
+        }
+    }
+    return {.w = w,
+            .rate = rate,
+            .predictedIter = predictIterations(rate, tol)};
+}
+
+IterationResult srnSteadyStateSorMixed(const Spmatrix& Q,
+                                       VectorMutableView prob, Real w,
+                                       Real tol, uint max_iter,
+                                       uint refine_interval)
+{
+    assert(Q.format == Spmatrix::RowCompressed);
+    assert(refine_interval > 0);
+    auto Qf = spmatrix2float(Q);
+    uint iter = 0;
+    Real error = NAN;
+    scale(1.0 / norm1(prob), prob);
+    auto residual = Vector(prob.size());
+    auto correction = Vector(prob.size());
+    while (iter < max_iter)
+    {
+        // Q * prob = 0, residual = -Q * prob
+        dot(Q, prob, mutableView(residual));
+        scale(-1.0, mutableView(residual));
+        fill(0.0, mutableView(correction));
+        for (uint k = 0; k < refine_interval && iter < max_iter; k++)
+        {
+            iter++;
+            sorSweep(Qf, mutableView(correction), residual, w);
+        }
+        blas::axpy(1.0, correction, prob);
+        Real n1 = norm1(prob);
+        // the change of the normalized probabilities
+        error = 0.0;
+        for (uint i = 0; i < prob.size(); i++)
+        {
+            Real prev = prob(i) - correction(i);
+            prob(i) /= n1;
+            Real diff = std::abs(prob(i) - prev);
+            if (error < diff || std::isnan(diff))
+            {
+                error = diff;
+            }
+        }
+        if (error < tol)
+        {
+            break;
+        }
+    }
+    return {.error = error, .nIter = iter};
+}
+
+static SrnSteadyStateSol steadyStateSor(const graph::CsrDiGraph& rg,
+                                        const std::vector<Real>& edge_rates,
+                                        const VectorConstView* init, Real w,
+                                        Real tol, uint max_iter,
+                                        bool reorder)
 {
-    auto Q = srnRateMatrix(rg, edge_rates);
     uint n = rg.nodeCount();
-    Vector prob(rg.nodeCount(), 1.0);
+    auto mat2node = reorder ? reverseCuthillMckee(rg) : Permutation(n);
+    auto Q = srnRateMatrix(rg, edge_rates, mat2node);
+    Vector prob(n, 1.0);
+    if (init)
+    {
+        if (init->size() != n)
+        {
+            throw std::invalid_argument(
+                "initial vector size does not match the state count");
+        }
+        copy(*init, mutableView(prob));
+        if (norm1(prob) <= 0.0)
+        {  // nothing to start from
+            fill(1.0, mutableView(prob));
+        }
+    }
     std::vector<uint> groupCount;
     groupCount.push_back(n);
-    if (rg.nodeCount() == 1)
+    if (n == 1)
     {
-        return SrnSteadyStateSol{Permutation(n), 0, std::move(groupCount),
-                                 std::move(prob)};
+        prob(0) = 1.0;
+        return SrnSteadyStateSol{std::move(mat2node), 0,
+                                 std::move(groupCount), std::move(prob)};
     }
     auto res = srnSteadyStateSor(Q, mutableView(prob), w, tol, max_iter);
     if (res.error > tol || std::isnan(res.error))
@@ -91,35 +246,247 @@ SrnSteadyStateSol srnSteadyStateSor(const graph::DiGraph& rg,
            << res.error << ", nIter = " << res.nIter << ".";
         throw std::invalid_argument(os.str());
     }
-    return SrnSteadyStateSol{Permutation(n), 0, std::move(groupCount),
+    return SrnSteadyStateSol{std::move(mat2node), 0, std::move(groupCount),
                              std::move(prob)};
 }
 
+SrnSteadyStateSol srnSteadyStateSor(const graph::CsrDiGraph& rg,
+                                    const std::vector<Real>& edge_rates,
+                                    Real w, Real tol, uint max_iter,
+                                    bool reorder)
+{
+    return steadyStateSor(rg, edge_rates, nullptr, w, tol, max_iter,
+                          reorder);
+}
+
+SrnSteadyStateSol srnSteadyStateSor(const graph::CsrDiGraph& rg,
+                                    const std::vector<Real>& edge_rates,
+                                    VectorConstView init, Real w, Real tol,
+                                    uint max_iter, bool reorder)
+{
+    return steadyStateSor(rg, edge_rates, &init, w, tol, max_iter, reorder);
+}
+
+// x = a * Av and returns norm1(x), in one pass
+static Real dotScaleNorm1(const Spmatrix& A, Real a, VectorConstView v,
+                          VectorMutableView x)
+{
+    if (A.format != Spmatrix::RowCompressed)
+    {
+        dot(A, v, x);
+        scale(a, x);
+        return norm1(x);
+    }
+    assert(A.ncol == v.size());
+    assert(A.nrow == x.size());
+    Real norm = 0.0;
+    for (uint row = 0; row < A.nrow; row++)
+    {
+        Real sum = 0.0;
+        for (uint k = A.ptr[row]; k < A.ptr[row + 1]; k++)
+        {
+            sum += A.val[k] * v(A.idx[k]);
+        }
+        x(row) = a * sum;
+        norm += std::abs(x(row));
+    }
+    return norm;
+}
+
+// The iterates alternate between prob and one buffer, and each one is
+// normalized lazily by the product that reads it. So an unchecked
+// iteration is a single pass, and a checked one adds a pass that
+// normalizes and compares.
 IterationResult srnSteadyStatePower(const splinear::Spmatrix& P,
                                     linear::VectorMutableView prob, Real tol,
-                                    uint max_iter)
+                                    uint max_iter, uint check_interval)
 {
+    assert(check_interval > 0);
     Real n1 = norm1(prob);
     scale(1.0 / n1, mutableView(prob));
 
-    auto next_prob = Vector(prob.size());
+    auto buffer = Vector(prob.size());
+    auto curr = prob;
+    auto next = mutableView(buffer);
+    Real curr_scale = 1.0;  // curr needs to be scaled by it
     uint iter;
     Real error = NAN;
     for (iter = 1; iter <= max_iter; iter++)
     {
-        dot(P, prob, mutableView(next_prob));
-        Real n1 = norm1(next_prob);
-        scale(1.0 / n1, mutableView(next_prob));
-        error = maxDiff(prob, next_prob);
-        copy(next_prob, prob);
-        if (error < tol)
+        bool check = iter % check_interval == 0 || iter == max_iter;
+        Real n1 = dotScaleNorm1(P, curr_scale, curr, next);
+        if (check)
+        {
+            error = scaleMaxDiff(1.0 / n1, next, curr_scale, curr);
+            curr_scale = 1.0;
+        }
+        else
+        {
+            curr_scale = 1.0 / n1;
+        }
+        std::swap(curr, next);
+        if (check && error < tol)
         {
             break;
         }
     }
+    if (&curr(0) != &prob(0))
+    {
+        copy(curr, prob);
+    }
+    scale(curr_scale, prob);
     return {.error = error, .nIter = iter};
 }
 
+// scales every active column of prob to a sum of 1. norm is scratch space
+// of one entry per lane.
+static void normalizeLanes(MatrixMutableView prob,
+                           const std::vector<char>& active,
+                           std::vector<Real>& norm)
+{
+    uint K = prob.ncol();
+    std::fill(norm.begin(), norm.end(), 0.0);
+    for (uint i = 0; i < prob.nrow(); i++)
+    {
+        for (uint lane = 0; lane < K; lane++)
+        {
+            norm[lane] += std::abs(prob(i, lane));
+        }
+    }
+    for (uint lane = 0; lane < K; lane++)
+    {
+        norm[lane] = active[lane] ? 1.0 / norm[lane] : 1.0;
+    }
+    for (uint i = 0; i < prob.nrow(); i++)
+    {
+        for (uint lane = 0; lane < K; lane++)
+        {
+            prob(i, lane) *= norm[lane];
+        }
+    }
+}
+
+// records the error of the active lanes and deactivates converged ones.
+// returns the number of active lanes left.
+static uint checkLanes(const std::vector<Real>& error, uint iter, Real tol,
+                       std::vector<char>& active,
+                       std::vector<IterationResult>& results)
+{
+    uint nactive = 0;
+    for (uint lane = 0; lane < active.size(); lane++)
+    {
+        if (active[lane])
+        {
+            results[lane] = {.error = error[lane], .nIter = iter};
+            if (error[lane] < tol)
+            {
+                active[lane] = 0;
+            }
+            else
+            {
+                nactive += 1;
+            }
+        }
+    }
+    return nactive;
+}
+
+// The batched counterpart of steadyStateSor with check_interval 1: the sweep
+// saves the old entries and sums both norms of every active lane, and one
+// more pass normalizes the lanes and measures their change.
+std::vector<IterationResult> srnSteadyStateSorBatch(
+    const SpmatrixBatch& Q, MatrixMutableView prob, Real w, Real tol,
+    uint max_iter)
+{
+    assert(Q.format == Spmatrix::RowCompressed);
+    uint K = prob.ncol();
+    std::vector<IterationResult> results(K, {.error = NAN, .nIter = 0});
+    std::vector<char> active(K, 1);
+    std::vector<Real> a(K);
+    std::vector<Real> b(K);
+    std::vector<Real> error(K);
+    normalizeLanes(prob, active, a);
+    auto prob_prev = Matrix(prob.nrow(), K);
+    auto prev_view = mutableView(prob_prev);
+    BatchSweepStats stats(K);
+    for (uint iter = 1; iter <= max_iter; iter++)
+    {
+        sorSweep(Q, prob, w, active, stats, &prev_view);
+        for (uint lane = 0; lane < K; lane++)
+        {
+            a[lane] = 1.0 / stats.newNorm[lane];
+            b[lane] = 1.0 / stats.oldNorm[lane];
+            error[lane] = 0.0;
+        }
+        for (uint i = 0; i < prob.nrow(); i++)
+        {
+            for (uint lane = 0; lane < K; lane++)
+            {
+                if (active[lane])
+                {
+                    prob(i, lane) *= a[lane];
+                    Real diff =
+                        std::abs(prob(i, lane) - b[lane] * prob_prev(i, lane));
+                    error[lane] = std::max(error[lane], diff);
+                }
+            }
+        }
+        if (checkLanes(error, iter, tol, active, results) == 0)
+        {
+            break;
+        }
+    }
+    return results;
+}
+
+std::vector<IterationResult> srnSteadyStatePowerBatch(
+    const SpmatrixBatch& P, MatrixMutableView prob, Real tol, uint max_iter)
+{
+    uint K = prob.ncol();
+    std::vector<IterationResult> results(K, {.error = NAN, .nIter = 0});
+    std::vector<char> active(K, 1);
+    std::vector<Real> scale(K);
+    std::vector<Real> error(K);
+    normalizeLanes(prob, active, scale);
+    auto next_prob = Matrix(prob.nrow(), K);
+    for (uint iter = 1; iter <= max_iter; iter++)
+    {
+        dot(P, prob, mutableView(next_prob), active);
+        std::fill(scale.begin(), scale.end(), 0.0);
+        for (uint i = 0; i < prob.nrow(); i++)
+        {
+            for (uint lane = 0; lane < K; lane++)
+            {
+                scale[lane] += std::abs(next_prob(i, lane));
+            }
+        }
+        // normalizes, compares and takes the new iterate in one pass
+        for (uint lane = 0; lane < K; lane++)
+        {
+            scale[lane] = 1.0 / scale[lane];
+            error[lane] = 0.0;
+        }
+        for (uint i = 0; i < prob.nrow(); i++)
+        {
+            for (uint lane = 0; lane < K; lane++)
+            {
+                if (active[lane])
+                {
+                    Real next = next_prob(i, lane) * scale[lane];
+                    error[lane] = std::max(error[lane],
+                                           std::abs(next - prob(i, lane)));
+                    prob(i, lane) = next;
+                }
+            }
+        }
+        if (checkLanes(error, iter, tol, active, results) == 0)
+        {
+            break;
+        }
+    }
+    return results;
+}
+
 struct StateReordering
 {
     uint ntan;  // number of tangible states
@@ -127,7 +494,7 @@ struct StateReordering
     std::vector<uint> nstatesList;  // number of bottom scc states
 };
 
-static StateReordering reorderState(const DiGraph& rg)
+static StateReordering reorderState(const CsrDiGraph& rg)
 {
     auto scc_list = decompScc(rg);
     std::vector<uint> mat2node;
@@ -155,11 +522,11 @@ static StateReordering reorderState(const DiGraph& rg)
     return {ntan, Permutation(std::move(mat2node), true), std::move(nstates)};
 }
 
-static Spmatrix ttRateMatrix(const DiGraph& rg,
-                             const std::vector<Real>& edge_rates,
-                             const Permutation& mat2node, uint ntan)
+static SpmatrixPattern ttRateMatrix(const CsrDiGraph& rg,
+                                    const std::vector<Real>& edge_rates,
+                                    const Permutation& mat2node, uint ntan)
 {
-    auto spmat = SpmatrixCreator(ntan, ntan);
+    auto spmat = SpmatrixPatternCreator(ntan, ntan, rg.edgeCount());
     for (uint j = 0; j < ntan; j++)
     {
         int nid = mat2node.forward(j);
@@ -167,32 +534,30 @@ static Spmatrix ttRateMatrix(const DiGraph& rg,
         const auto& node = rg.getNode((uint)nid);
         for (const auto& edge : node.edges)
         {
-            Real rate = edge_rates[edge.eid];
             int i = mat2node.backward(edge.dst);
             assert(i >= 0);
             if ((uint)i < ntan)
             {
-                spmat.addEntry((uint)i, j, rate);
-                spmat.addEntry(j, j, -rate);
+                spmat.addEntry((uint)i, j, edge.eid, 1.0);
+                spmat.addEntry(j, j, edge.eid, -1.0);
             }
             else
             {  // dst is not in the matrix
-                spmat.addEntry(j, j, -rate);
+                spmat.addEntry(j, j, edge.eid, -1.0);
             }
         }
     }
-    return spmat.create(Spmatrix::RowCompressed);
+    return spmat.create(Spmatrix::RowCompressed, edge_rates);
 }
 
-static Spmatrix taRateMatrix(const DiGraph& rg,
-                             const std::vector<Real>& edge_rates,
-                             const Permutation& mat2node, uint ntan,
-                             uint abs_start, uint abs_end)
+// rates from transient states to all the absorbing states, in one pass
+// over the transient states
+static SpmatrixPattern taRateMatrix(const CsrDiGraph& rg,
+                                    const std::vector<Real>& edge_rates,
+                                    const Permutation& mat2node, uint ntan)
 {
-    assert(abs_start >= ntan);
-    assert(abs_end > abs_start);
-    uint nabs = abs_end - abs_start;
-    auto spmat = SpmatrixCreator(nabs, ntan);
+    uint nabs = rg.nodeCount() - ntan;
+    auto spmat = SpmatrixPatternCreator(nabs, ntan, rg.edgeCount());
     for (uint j = 0; j < ntan; j++)
     {
         int nid = mat2node.forward(j);
@@ -200,71 +565,155 @@ static Spmatrix taRateMatrix(const DiGraph& rg,
         const auto& node = rg.getNode((uint)nid);
         for (const auto& edge : node.edges)
         {
-            Real rate = edge_rates[edge.eid];
             int i = mat2node.backward(edge.dst);
             assert(i >= 0);
-            if ((uint)i >= abs_start && (uint)i < abs_end)
+            if ((uint)i >= ntan)
             {
-                spmat.addEntry((uint)i - abs_start, j, rate);
+                spmat.addEntry((uint)i - ntan, j, edge.eid, 1.0);
             }
         }
     }
-    return spmat.create(Spmatrix::RowCompressed);
+    return spmat.create(Spmatrix::RowCompressed, edge_rates);
 }
 
 // the last row is replaced with all 1s
-static Spmatrix aaRateMatrix(const DiGraph& rg,
-                             const std::vector<Real>& edge_rates,
-                             const Permutation& mat2node, uint abs_start,
-                             uint abs_end)
+static SpmatrixPattern aaRateMatrix(const CsrDiGraph& rg,
+                                    const std::vector<Real>& edge_rates,
+                                    const Permutation& mat2node,
+                                    uint abs_start, uint abs_end)
 {
     assert(abs_end > abs_start);
     uint nabs = abs_end - abs_start;
-    auto spmat = SpmatrixCreator(nabs, nabs);
+    auto spmat = SpmatrixPatternCreator(nabs, nabs, rg.edgeCount());
     for (uint j = abs_start; j < abs_end; j++)
     {
         int nid = mat2node.forward(j);
         assert(nid >= 0);
         const auto& node = rg.getNode((uint)nid);
-        Real total_rate = 0.0;
         for (const auto& edge : node.edges)
         {
-            Real rate = edge_rates[edge.eid];
             int i = mat2node.backward(edge.dst);
             assert(i >= 0);
             assert((uint)i >= abs_start);
-            total_rate += rate;
             if ((uint)i != abs_end - 1)  // excluding the last row
             {
-                spmat.addEntry((uint)i - abs_start, j - abs_start, rate);
+                spmat.addEntry((uint)i - abs_start, j - abs_start, edge.eid,
+                               1.0);
+            }
+            if (j != abs_end - 1)
+            {
+                spmat.addEntry(j - abs_start, j - abs_start, edge.eid, -1.0);
             }
         }
-        if (j != abs_end - 1)
+        spmat.addConstant(abs_end - 1 - abs_start, j - abs_start,
+                          1.0);  // adding the last row
+    }
+    return spmat.create(Spmatrix::RowCompressed, edge_rates);
+}
+
+SpmatrixPattern srnRateMatrixPattern(const CsrDiGraph& reach_graph,
+                                     const std::vector<Real>& edge_rates)
+{
+    const uint n = reach_graph.nodeCount();
+    auto spmat = SpmatrixPatternCreator(n, n, reach_graph.edgeCount());
+    for (uint j = 0; j < n; j++)
+    {
+        const auto& node = reach_graph.getNode(j);
+        for (const auto& edge : node.edges)
         {
-            spmat.addEntry(j - abs_start, j - abs_start, -total_rate);
+            spmat.addEntry(edge.dst, j, edge.eid, 1.0);
+            spmat.addEntry(j, j, edge.eid, -1.0);
         }
-        spmat.addEntry(abs_end - 1 - abs_start, j - abs_start,
-                       1.0);  // adding the last
-                              // row
     }
-    return spmat.create(Spmatrix::RowCompressed);
+    return spmat.create(Spmatrix::RowCompressed, edge_rates);
 }
 
-SrnSteadyStateSol srnSteadyStateDecomp(
-    const graph::DiGraph& rg, const std::vector<Real>& edge_rates,
+// the first matrix index of every bottom scc, and the end of the last one
+static std::vector<uint> absStarts(const SrnDecompPattern& pat)
+{
+    std::vector<uint> starts(1, pat.ntan);
+    for (uint nabs : pat.nstatesList)
+    {
+        starts.push_back(starts.back() + nabs);
+    }
+    return starts;
+}
+
+SrnDecompPattern srnSteadyStateDecompPattern(
+    const graph::CsrDiGraph& rg, const std::vector<Real>& edge_rates,
+    uint nthread)
+{
+    auto reorder = reorderState(rg);
+    uint nblock = reorder.nstatesList.size();
+    // filled below
+    auto empty = SpmatrixPattern{Spmatrix(0, 0, Spmatrix::RowCompressed), {}};
+    SrnDecompPattern pat{.nstate = rg.nodeCount(),
+                         .ntan = reorder.ntan,
+                         .mat2node = std::move(reorder.mat2node),
+                         .nstatesList = std::move(reorder.nstatesList),
+                         .QTT = empty,
+                         .QTA = empty,
+                         .QAA = std::vector<SpmatrixPattern>(nblock, empty)};
+    auto starts = absStarts(pat);
+    // the blocks are independent: QTT, QTA, then every QAA
+    parallel::parallelForDynamic(0, nblock + 2, nthread, [&](uint, uint k) {
+        if (k == 0)
+        {
+            pat.QTT = ttRateMatrix(rg, edge_rates, pat.mat2node, pat.ntan);
+        }
+        else if (k == 1)
+        {
+            pat.QTA = taRateMatrix(rg, edge_rates, pat.mat2node, pat.ntan);
+        }
+        else
+        {
+            pat.QAA[k - 2] = aaRateMatrix(rg, edge_rates, pat.mat2node,
+                                          starts[k - 2], starts[k - 1]);
+        }
+    });
+    return pat;
+}
+
+// every block only refreshes the values of its own edges
+static void updatePattern(SrnDecompPattern& pattern,
+                          const std::vector<Real>& edge_rates, uint nthread)
+{
+    uint nblock = pattern.QAA.size();
+    parallel::parallelForDynamic(0, nblock + 2, nthread, [&](uint, uint k) {
+        if (k == 0)
+        {
+            updateValues(pattern.QTT, edge_rates);
+        }
+        else if (k == 1)
+        {
+            updateValues(pattern.QTA, edge_rates);
+        }
+        else
+        {
+            updateValues(pattern.QAA[k - 2], edge_rates);
+        }
+    });
+}
+
+static SrnSteadyStateSol solveDecomp(
+    const SrnDecompPattern& pat,
     const std::vector<MarkingInitProb>& init_probs,
     const std::function<void(const splinear::Spmatrix& A,
                              linear::VectorMutableView x,
-                             linear::VectorConstView b)>& spsolver)
-
+                             linear::VectorConstView b)>& spsolver,
+    const VectorConstView* guess, uint nthread)
 {
-    auto reorder = reorderState(rg);
-    Vector solution(rg.nodeCount(), 0.0);
+    if (guess && guess->size() != pat.nstate)
+    {
+        throw std::invalid_argument(
+            "initial vector size does not match the state count");
+    }
+    Vector solution(pat.nstate, 0.0);
     for (const auto& mkp : init_probs)
     {
-        int mat_idx = reorder.mat2node.backward(mkp.idx);
+        int mat_idx = pat.mat2node.backward(mkp.idx);
         assert(mat_idx >= 0);
-        if ((uint)mat_idx < reorder.ntan)
+        if ((uint)mat_idx < pat.ntan)
         {
             solution((uint)mat_idx) = -mkp.prob;
         }
@@ -274,30 +723,34 @@ SrnSteadyStateSol srnSteadyStateDecomp(
         }
     }
 
-    // solving Q_TT * tau = - pi(0)
-    if (reorder.ntan > 0)
+    if (pat.ntan > 0)
     {
-        auto QTT =
-            ttRateMatrix(rg, edge_rates, reorder.mat2node, reorder.ntan);
-        auto sol = blockView(mutableView(solution), 0, reorder.ntan);
+        // solving Q_TT * tau = - pi(0)
+        const auto& QTT = pat.QTT.matrix;
+        auto sol = blockView(mutableView(solution), 0, pat.ntan);
         auto b = Vector(sol);
-        // guess a solution
-        fill(1.0, sol);
+        if (guess)
+        {
+            copy(blockView(*guess, 0, pat.ntan), sol);
+        }
+        else
+        {  // guess a solution
+            fill(1.0, sol);
+        }
         spsolver(QTT, sol, b);
+
+        // sol(ntan, nstate) += Q_TA * tau
+        auto abs_sol = blockView(mutableView(solution), pat.ntan,
+                                 pat.nstate - pat.ntan);
+        dotpx(pat.QTA.matrix, blockView(solution, 0, pat.ntan), abs_sol);
     }
 
-    uint abs_start = reorder.ntan;
-    for (uint nabs : reorder.nstatesList)
-    {
-        // sol(0, ntan) = Q_TA * tau
-        uint abs_end = abs_start + nabs;
-        if (reorder.ntan > 0)
-        {
-            auto QTA = taRateMatrix(rg, edge_rates, reorder.mat2node,
-                                    reorder.ntan, abs_start, abs_end);
-            auto sol = blockView(mutableView(solution), abs_start, nabs);
-            dotpx(QTA, blockView(solution, 0, reorder.ntan), sol);
-        }
+    auto starts = absStarts(pat);
+    uint nblock = pat.nstatesList.size();
+    parallel::parallelForDynamic(0, nblock, nthread, [&](uint, uint k) {
+        uint abs_start = starts[k];
+        uint abs_end = starts[k + 1];
+        uint nabs = abs_end - abs_start;
 
         // Q_AA * sol(abs_start, abs_end) = [0,0, ..., total_prob]^T
         Real total_prob = 0.0;
@@ -305,26 +758,83 @@ SrnSteadyStateSol srnSteadyStateDecomp(
         {
             total_prob += solution(i);
         }
-        {
-            auto QAA = aaRateMatrix(rg, edge_rates, reorder.mat2node,
-                                    abs_start, abs_end);
+        const auto& QAA = pat.QAA[k].matrix;
 
-            // right hand side
-            auto b = Vector(nabs, 0.0);
-            b(nabs - 1) = 1.0;
+        // right hand side
+        auto b = Vector(nabs, 0.0);
+        b(nabs - 1) = 1.0;
 
-            // guess (1/n, 1/n, ..., 1/n)
-            auto sol = blockView(mutableView(solution), abs_start, nabs);
+        auto sol = blockView(mutableView(solution), abs_start, nabs);
+        Real guess_norm = 0.0;
+        if (guess)
+        {  // the block of the guess, normalized like the solution
+            copy(blockView(*guess, abs_start, nabs), sol);
+            guess_norm = norm1(sol);
+        }
+        if (guess_norm > 0.0)
+        {
+            scale(1.0 / guess_norm, sol);
+        }
+        else
+        {  // guess (1/n, 1/n, ..., 1/n)
             fill(1.0 / (Real)nabs, sol);
-            spsolver(QAA, sol, b);
-            scale(total_prob, sol);
         }
-        abs_start = abs_end;
-    }
+        spsolver(QAA, sol, b);
+        scale(total_prob, sol);
+    });
 
-    return {.matrix2node = std::move(reorder.mat2node),
-            .nTransient = reorder.ntan,
-            .absGroupSizes = std::move(reorder.nstatesList),
+    return {.matrix2node = pat.mat2node,
+            .nTransient = pat.ntan,
+            .absGroupSizes = pat.nstatesList,
             .solution = std::move(solution)};
 }
+
+SrnSteadyStateSol srnSteadyStateDecomp(
+    const graph::CsrDiGraph& rg, const std::vector<Real>& edge_rates,
+    const std::vector<MarkingInitProb>& init_probs,
+    const std::function<void(const splinear::Spmatrix& A,
+                             linear::VectorMutableView x,
+                             linear::VectorConstView b)>& spsolver,
+    uint nthread)
+
+{
+    auto pat = srnSteadyStateDecompPattern(rg, edge_rates, nthread);
+    return solveDecomp(pat, init_probs, spsolver, nullptr, nthread);
+}
+
+SrnSteadyStateSol srnSteadyStateDecomp(
+    const graph::CsrDiGraph& rg, const std::vector<Real>& edge_rates,
+    const std::vector<MarkingInitProb>& init_probs, VectorConstView guess,
+    const std::function<void(const splinear::Spmatrix& A,
+                             linear::VectorMutableView x,
+                             linear::VectorConstView b)>& spsolver,
+    uint nthread)
+{
+    auto pat = srnSteadyStateDecompPattern(rg, edge_rates, nthread);
+    return solveDecomp(pat, init_probs, spsolver, &guess, nthread);
+}
+
+SrnSteadyStateSol srnSteadyStateDecomp(
+    SrnDecompPattern& pattern, const std::vector<Real>& edge_rates,
+    const std::vector<MarkingInitProb>& init_probs,
+    const std::function<void(const splinear::Spmatrix& A,
+                             linear::VectorMutableView x,
+                             linear::VectorConstView b)>& spsolver,
+    uint nthread)
+{
+    updatePattern(pattern, edge_rates, nthread);
+    return solveDecomp(pattern, init_probs, spsolver, nullptr, nthread);
+}
+
+SrnSteadyStateSol srnSteadyStateDecomp(
+    SrnDecompPattern& pattern, const std::vector<Real>& edge_rates,
+    const std::vector<MarkingInitProb>& init_probs, VectorConstView guess,
+    const std::function<void(const splinear::Spmatrix& A,
+                             linear::VectorMutableView x,
+                             linear::VectorConstView b)>& spsolver,
+    uint nthread)
+{
+    updatePattern(pattern, edge_rates, nthread);
+    return solveDecomp(pattern, init_probs, spsolver, &guess, nthread);
+}
 }  // namespace sanity::petrinet
@@ -9,18 +9,69 @@
 
 namespace sanity::petrinet
 {
-splinear::Spmatrix srnRateMatrix(const graph::DiGraph& reach_graph,
+splinear::Spmatrix srnRateMatrix(const graph::CsrDiGraph& reach_graph,
                                  const std::vector<Real>& edge_rates);
+// the same matrix with its rows and columns in matrix order, i.e.
+// mat2node.forward(i) is the node of row i
+splinear::Spmatrix srnRateMatrix(const graph::CsrDiGraph& reach_graph,
+                                 const std::vector<Real>& edge_rates,
+                                 const linear::Permutation& mat2node);
+// same matrix, but keeping the position of every edge rate so that new
+// rates can be written with splinear::updateValues
+splinear::SpmatrixPattern srnRateMatrixPattern(
+    const graph::CsrDiGraph& reach_graph,
+    const std::vector<Real>& edge_rates);
 
-// Power method, P needs to be a unified prob matrix
+// Power method, P needs to be a unified prob matrix. Convergence is only
+// checked every check_interval iterations (and at max_iter), which saves a
+// pass over the vectors in the other iterations.
 IterationResult srnSteadyStatePower(const splinear::Spmatrix& P,
                                     linear::VectorMutableView prob, Real tol,
-                                    uint max_iter);
+                                    uint max_iter, uint check_interval = 1);
 
-// SOR method, only good for irreducible Markov chains
+// SOR method, only good for irreducible Markov chains. check_interval is
+// the same as above.
 IterationResult srnSteadyStateSor(const splinear::Spmatrix& Q,
                                   linear::VectorMutableView prob, Real w,
-                                  Real tol, uint max_iter);
+                                  Real tol, uint max_iter,
+                                  uint check_interval = 1);
+// same as above, with 16 bit column indices
+IterationResult srnSteadyStateSor(const splinear::SpmatrixCompact& Q,
+                                  linear::VectorMutableView prob, Real w,
+                                  Real tol, uint max_iter,
+                                  uint check_interval = 1);
+
+// Relaxation factor for srnSteadyStateSor, the better of 1 and
+// splinear::sorOptimalRelaxation, with the convergence rate of SOR and the
+// predicted number of sweeps for tol. Callers can give up on a slowly
+// mixing chain before sweeping if predictedIter exceeds their budget.
+struct SrnSorPlan
+{
+    Real w;
+    Real rate;
+    uint predictedIter;
+};
+SrnSorPlan srnSorPlan(const splinear::Spmatrix& Q, Real tol,
+                      uint arnoldi_steps = 30);
+
+// SOR method with single precision matrix values. Every refine_interval
+// sweeps, the residual is recomputed in double precision and the sweeps
+// solve for its correction, so the final accuracy is the same as
+// srnSteadyStateSor.
+IterationResult srnSteadyStateSorMixed(const splinear::Spmatrix& Q,
+                                       linear::VectorMutableView prob, Real w,
+                                       Real tol, uint max_iter,
+                                       uint refine_interval = 10);
+
+// Batched variants. Every column of prob is a lane with its own initial
+// vector, and Q (or P) holds either one matrix per lane or one shared
+// matrix. A lane stops being updated once it converges.
+std::vector<IterationResult> srnSteadyStateSorBatch(
+    const splinear::SpmatrixBatch& Q, linear::MatrixMutableView prob,
+    Real w, Real tol, uint max_iter);
+std::vector<IterationResult> srnSteadyStatePowerBatch(
+    const splinear::SpmatrixBatch& P, linear::MatrixMutableView prob,
+    Real tol, uint max_iter);
 
 struct SrnSteadyStateSol
 {
@@ -34,16 +85,78 @@ struct SrnSteadyStateSol
                               // for absorbings, the values are probabilities.
 };
 
-SrnSteadyStateSol srnSteadyStateSor(const graph::DiGraph& rg,
+// With reorder set, the states are put in reverse Cuthill-McKee order,
+// which reduces the bandwidth of the rate matrix and improves locality of
+// the sweeps. The solution is in matrix order either way.
+SrnSteadyStateSol srnSteadyStateSor(const graph::CsrDiGraph& rg,
                                     const std::vector<Real>& edge_rates,
-                                    Real w, Real tol, uint max_iter);
+                                    Real w, Real tol, uint max_iter,
+                                    bool reorder = false);
+// starting from init instead of a uniform vector. init is in matrix order,
+// e.g. the solution of an earlier call with the same graph and reorder.
+SrnSteadyStateSol srnSteadyStateSor(const graph::CsrDiGraph& rg,
+                                    const std::vector<Real>& edge_rates,
+                                    linear::VectorConstView init, Real w,
+                                    Real tol, uint max_iter,
+                                    bool reorder = false);
+
+// Decomposition method. The bottom sccs are independent once the
+// transient block is solved, so their matrices are assembled and solved by
+// nthread threads (0 for every hardware thread). spsolver needs to be
+// thread safe if nthread != 1.
+SrnSteadyStateSol srnSteadyStateDecomp(
+    const graph::CsrDiGraph& rg, const std::vector<Real>& edge_rates,
+    const std::vector<MarkingInitProb>& init_probs,
+    const std::function<void(const splinear::Spmatrix& A,
+                             linear::VectorMutableView x,
+                             linear::VectorConstView b)>& spsolver,
+    uint nthread = 1);
+// guess is in the format of SrnSteadyStateSol::solution. Its transient
+// part is the initial vector of the transient solve and every bottom scc
+// block, normalized, is the initial vector of that block's solve.
+SrnSteadyStateSol srnSteadyStateDecomp(
+    const graph::CsrDiGraph& rg, const std::vector<Real>& edge_rates,
+    const std::vector<MarkingInitProb>& init_probs,
+    linear::VectorConstView guess,
+    const std::function<void(const splinear::Spmatrix& A,
+                             linear::VectorMutableView x,
+                             linear::VectorConstView b)>& spsolver,
+    uint nthread = 1);
+
+// The matrices of the decomposition method. They only depend on the
+// structure of the reachability graph, so the same pattern can be reused
+// for every set of edge rates.
+struct SrnDecompPattern
+{
+    uint nstate;
+    uint ntan;  // number of transient states
+    linear::Permutation mat2node;
+    std::vector<uint> nstatesList;  // number of states in each bottom scc
+    splinear::SpmatrixPattern QTT;
+    splinear::SpmatrixPattern QTA;  // rows of all the bottom sccs
+    std::vector<splinear::SpmatrixPattern> QAA;  // one per bottom scc
+};
+
+SrnDecompPattern srnSteadyStateDecompPattern(
+    const graph::CsrDiGraph& rg, const std::vector<Real>& edge_rates,
+    uint nthread = 1);
 
-// decomposition method
+// decomposition method with a prebuilt pattern, whose values are refreshed
+// from edge_rates
+SrnSteadyStateSol srnSteadyStateDecomp(
+    SrnDecompPattern& pattern, const std::vector<Real>& edge_rates,
+    const std::vector<MarkingInitProb>& init_probs,
+    const std::function<void(const splinear::Spmatrix& A,
+                             linear::VectorMutableView x,
+                             linear::VectorConstView b)>& spsolver,
+    uint nthread = 1);
 SrnSteadyStateSol srnSteadyStateDecomp(
-    const graph::DiGraph& rg, const std::vector<Real>& edge_rates,
+    SrnDecompPattern& pattern, const std::vector<Real>& edge_rates,
     const std::vector<MarkingInitProb>& init_probs,
+    linear::VectorConstView guess,
     const std::function<void(const splinear::Spmatrix& A,
                              linear::VectorMutableView x,
-                             linear::VectorConstView b)>& spsolver);
+                             linear::VectorConstView b)>& spsolver,
+    uint nthread = 1);
 
 }  // namespace sanity::petrinet
@@ -9,7 +9,8 @@ using namespace sanity::linear;
 
 namespace sanity::petrinet
 {
-Real maxOutRate(const graph::DiGraph& rg, const std::vector<Real>& edge_rates)
+Real maxOutRate(const graph::CsrDiGraph& rg,
+                const std::vector<Real>& edge_rates)
 {
     Real max = 0.0;
     for (uint src_idx = 0; src_idx < rg.nodeCount(); src_idx++)
@@ -28,7 +29,7 @@ Real maxOutRate(const graph::DiGraph& rg, const std::vector<Real>& edge_rates)
     return max;
 }
 
-Spmatrix probMatrix(const graph::DiGraph& rg,
+Spmatrix probMatrix(const graph::CsrDiGraph& rg,
                     const std::vector<Real>& edge_rates, Real unif_rate)
 {
     auto n = rg.nodeCount();
@@ -51,12 +52,14 @@ Spmatrix probMatrix(const graph::DiGraph& rg,
 }
 
 linear::Vector srnTransientProb(
-    const graph::DiGraph& rg, const std::vector<Real>& edge_rates,
+    const graph::CsrDiGraph& rg, const std::vector<Real>& edge_rates,
     const std::vector<MarkingInitProb>& init_probs, Real time,
     Real unif_rate_factor, Real tol, uint ss_check_interval)
 {
     auto unif_rate = maxOutRate(rg, edge_rates) * unif_rate_factor;
-    auto P = probMatrix(rg, edge_rates, unif_rate);
+    // the vector-matrix products below dominate, so P is stored in the
+    // SIMD friendly sliced ELLPACK format
+    auto P = spmatrix2sell(probMatrix(rg, edge_rates, unif_rate));
 
     auto n = rg.nodeCount();
 
@@ -1,5 +1,11 @@
 #pragma once
 
 #include "simulate/dsim.hpp"
+#include "simulate/philox.hpp"
 #include "simulate/random.hpp"
+#include "simulate/replicate.hpp"
+#include "simulate/splitting.hpp"
+#include "simulate/stats.hpp"
+#include "simulate/steady.hpp"
+#include "simulate/sumtree.hpp"
 #include "simulate/utils.hpp"
@@ -1,5 +1,7 @@
 #pragma once
 #include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <functional>
 #include <vector>
 #include "type.hpp"
@@ -27,75 +29,242 @@ struct EventT
     }
 };
 
-template <typename EventData>
-struct EventComp
+// Identifies a scheduled event. A handle stays valid until its event is
+// popped, cancelled or rescheduled; after that the queue ignores it, even
+// if its slot is reused.
+struct EventHandle
 {
-    bool operator()(const EventT<EventData>& e1,
-                    const EventT<EventData>& e2) const
-    {
-        return e1.time > e2.time;
-    }
+    uint slot;
+    std::uint64_t seq;
+    bool valid() const { return seq != 0; }
 };
 
+// Pending events in an indexed binary heap ordered by time. Events with the
+// same time are popped in the order they were scheduled. schedule, pop,
+// cancel and reschedule are O(log n).
 template <typename EventData>
 class EventQueueT
 {
 public:
     using Event = EventT<EventData>;
+    using Handle = EventHandle;
 
 private:
-    std::vector<Event> _pending_events;
-    void schedule(Event event)
+    struct Slot
+    {
+        Event event;
+        std::uint64_t seq;  // 0 if the slot is free
+        uint heapPos;
+    };
+    std::vector<Slot> _slots;
+    std::vector<uint> _free_slots;
+    std::vector<uint> _heap;  // slots
+    std::uint64_t _next_seq = 1;
+
+    bool before(uint s1, uint s2) const
+    {
+        const auto& e1 = _slots[s1];
+        const auto& e2 = _slots[s2];
+        return e1.event.time < e2.event.time ||
+               (e1.event.time == e2.event.time && e1.seq < e2.seq);
+    }
+    void place(uint pos, uint slot)
+    {
+        _heap[pos] = slot;
+        _slots[slot].heapPos = pos;
+    }
+    void siftUp(uint pos)
+    {
+        uint slot = _heap[pos];
+        while (pos > 0)
+        {
+            uint parent = (pos - 1) / 2;
+            if (!before(slot, _heap[parent]))
+            {
+                break;
+            }
+            place(pos, _heap[parent]);
+            pos = parent;
+        }
+        place(pos, slot);
+    }
+    void siftDown(uint pos)
+    {
+        uint slot = _heap[pos];
+        uint n = _heap.size();
+        while (true)
+        {
+            uint child = 2 * pos + 1;
+            if (child >= n)
+            {
+                break;
+            }
+            if (child + 1 < n && before(_heap[child + 1], _heap[child]))
+            {
+                child++;
+            }
+            if (!before(_heap[child], slot))
+            {
+                break;
+            }
+            place(pos, _heap[child]);
+            pos = child;
+        }
+        place(pos, slot);
+    }
+    // moves the event of the slot out of the heap and frees the slot
+    Event take(uint slot)
     {
-        auto pos =
-            std::lower_bound(_pending_events.begin(), _pending_events.end(),
-                             event, EventComp<EventData>());
-        _pending_events.insert(pos, std::move(event));
+        uint pos = _slots[slot].heapPos;
+        uint last = _heap.back();
+        _heap.pop_back();
+        if (last != slot)
+        {
+            place(pos, last);
+            siftDown(pos);
+            siftUp(_slots[last].heapPos);
+        }
+        _slots[slot].seq = 0;
+        _free_slots.push_back(slot);
+        return std::move(_slots[slot].event);
+    }
+    Handle schedule(Event event)
+    {
+        uint slot;
+        if (_free_slots.empty())
+        {
+            slot = _slots.size();
+            _slots.push_back(Slot{std::move(event), 0, 0});
+        }
+        else
+        {
+            slot = _free_slots.back();
+            _free_slots.pop_back();
+            _slots[slot].event = std::move(event);
+        }
+        _slots[slot].seq = _next_seq++;
+        _heap.push_back(slot);
+        siftUp(_heap.size() - 1);
+        return {slot, _slots[slot].seq};
     }
 
 public:
-    void schedule(Real time, EventData data)
+    Handle schedule(Real time, EventData data)
     {
-        schedule(Event{EventType::User, time, std::move(data)});
+        return schedule(Event{EventType::User, time, std::move(data)});
     }
+    bool contains(Handle h) const
+    {
+        return h.valid() && h.slot < _slots.size() &&
+               _slots[h.slot].seq == h.seq;
+    }
+    // false if the event is no longer pending. the cancelled event is
+    // written to buf if given.
+    bool cancel(Handle h, Event* buf = nullptr)
+    {
+        if (!contains(h))
+        {
+            return false;
+        }
+        auto evt = take(h.slot);
+        if (buf)
+        {
+            *buf = std::move(evt);
+        }
+        return true;
+    }
+    // moves a pending event to a new time. it is ordered after the events
+    // already scheduled at that time, and gets a new handle.
+    Handle reschedule(Handle h, Real time)
+    {
+        assert(contains(h));
+        auto& slot = _slots[h.slot];
+        slot.event.time = time;
+        slot.seq = _next_seq++;
+        siftDown(slot.heapPos);
+        siftUp(slot.heapPos);
+        return {h.slot, slot.seq};
+    }
+    // O(n + k log n) for k removed events, prefer cancel. the removed
+    // events are returned in the order they would have fired.
     std::vector<Event> remove(
         const std::function<bool(const Event& evt)>& should_remove)
     {
-        auto first = std::remove_if(_pending_events.begin(),
-                                    _pending_events.end(), should_remove);
-        auto res = std::vector<Event>(first, _pending_events.end());
-        _pending_events.erase(first, _pending_events.end());
+        std::vector<uint> slots;
+        for (uint slot : _heap)
+        {
+            if (should_remove(_slots[slot].event))
+            {
+                slots.push_back(slot);
+            }
+        }
+        std::sort(slots.begin(), slots.end(),
+                  [this](uint s1, uint s2) { return before(s1, s2); });
+        std::vector<Event> res;
+        for (uint slot : slots)
+        {
+            res.push_back(take(slot));
+        }
         return res;
     }
+    // O(n), prefer cancel. removes the matching event that would fire last.
     bool removeFirst(
         const std::function<bool(const Event& evt)>& should_remove,
         Event* buf)
     {
-        auto first = std::find_if(_pending_events.begin(),
-                                  _pending_events.end(), should_remove);
-        if (first != _pending_events.end())
+        bool found = false;
+        uint last = 0;
+        for (uint slot : _heap)
         {
-            *buf = *first;
-            _pending_events.erase(first, first + 1);
-            return true;
+            if (should_remove(_slots[slot].event) &&
+                (!found || before(last, slot)))
+            {
+                last = slot;
+                found = true;
+            }
         }
-        else
+        if (found)
         {
-            return false;
+            *buf = take(last);
         }
+        return found;
     }
-    uint size() const { return _pending_events.size(); }
+    uint size() const { return _heap.size(); }
     Event pop()
     {
-        auto res = std::move(_pending_events.back());
-        _pending_events.pop_back();
+        assert(size() > 0);
+        return take(_heap.front());
+    }
+    const Event& peek() const
+    {
+        assert(size() > 0);
+        return _slots[_heap.front()].event;
+    }
+    // the pending events in the order they will be popped, O(n log n)
+    std::vector<Event> events() const
+    {
+        std::vector<Event> res;
+        for (uint slot : pendingSlots())
+        {
+            res.push_back(_slots[slot].event);
+        }
         return res;
     }
-    const Event& peek(uint i = 0) const
+    void clear()
+    {
+        _slots.clear();
+        _free_slots.clear();
+        _heap.clear();
+    }
+
+private:
+    std::vector<uint> pendingSlots() const
     {
-        return _pending_events[_pending_events.size() - 1 - i];
+        auto slots = _heap;
+        std::sort(slots.begin(), slots.end(),
+                  [this](uint s1, uint s2) { return before(s1, s2); });
+        return slots;
     }
-    void clear() { _pending_events.clear(); }
 };
 
 template <typename EventData, typename StateType>
@@ -132,6 +301,8 @@ public:
         _handlers[hidx] = std::move(handler);
     }
     void addObserver(Observer& ob) { _obs.push_back(&ob); }
+    // a copied simulator still notifies the observers of the original
+    void clearObservers() { _obs.clear(); }
     void begin()
     {
         _queue.clear();
@@ -165,12 +336,28 @@ public:
             processEvent(evt);
         }
     }
+    // processes the next event if it happens no later than limit and
+    // returns whether there was one. The clock stays at the time of the
+    // event, as in runTillEnd.
+    bool step(Real limit)
+    {
+        if (_queue.size() == 0 || _queue.peek().time > limit)
+        {
+            return false;
+        }
+        auto evt = _queue.pop();
+        _time = evt.time;
+        processEvent(evt);
+        return true;
+    }
     void end()
     {
         auto evt = Event(EventType::End, _time);
         processEvent(evt);
     }
     Real time() const { return _time; }
+    State& state() { return _state; }
+    const State& state() const { return _state; }
 
 private:
     void processEvent(const Event& evt)
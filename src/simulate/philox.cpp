@@ -0,0 +1,191 @@
+#include "philox.hpp"
+#include "random.hpp"
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace sanity::simulate
+{
+static const std::uint32_t philoxM0 = 0xD2511F53;
+static const std::uint32_t philoxM1 = 0xCD9E8D57;
+static const std::uint32_t philoxW0 = 0x9E3779B9;
+static const std::uint32_t philoxW1 = 0xBB67AE85;
+
+PhiloxCounter philox4x32(PhiloxCounter ctr, PhiloxKey key)
+{
+    for (uint r = 0; r < 10; r++)
+    {
+        std::uint64_t p0 = (std::uint64_t)philoxM0 * ctr[0];
+        std::uint64_t p1 = (std::uint64_t)philoxM1 * ctr[2];
+        ctr = {(std::uint32_t)(p1 >> 32) ^ ctr[1] ^ key[0],
+               (std::uint32_t)p1,
+               (std::uint32_t)(p0 >> 32) ^ ctr[3] ^ key[1],
+               (std::uint32_t)p0};
+        key[0] += philoxW0;
+        key[1] += philoxW1;
+    }
+    return ctr;
+}
+
+// a uniform on (0, 1) from the upper 53 bits of hi:lo
+static inline Real toUniform(std::uint32_t hi, std::uint32_t lo)
+{
+    std::uint64_t bits = (((std::uint64_t)hi << 32) | lo) >> 11;
+    return ((Real)bits + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+static inline PhiloxCounter blockCounter(std::uint64_t block,
+                                         std::uint64_t stream)
+{
+    return {(std::uint32_t)block, (std::uint32_t)(block >> 32),
+            (std::uint32_t)stream, (std::uint32_t)(stream >> 32)};
+}
+
+static void philoxUniforms(PhiloxKey key, std::uint64_t stream,
+                           std::uint64_t first, uint nblock, Real* out)
+{
+    for (uint b = 0; b < nblock; b++)
+    {
+        auto r = philox4x32(blockCounter(first + b, stream), key);
+        out[2 * b] = toUniform(r[1], r[0]);
+        out[2 * b + 1] = toUniform(r[3], r[2]);
+    }
+}
+
+#if defined(__x86_64__)
+// high and low halves of the 32x32 bit products of the 8 lanes of c with m
+__attribute__((target("avx2"))) static inline void mulhilo8(__m256i m,
+                                                            __m256i c,
+                                                            __m256i& hi,
+                                                            __m256i& lo)
+{
+    __m256i even = _mm256_mul_epu32(m, c);
+    __m256i odd = _mm256_mul_epu32(m, _mm256_srli_epi64(c, 32));
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xaa);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+}
+
+// runs the rounds of 8 blocks at a time, one block per 32 bit lane
+__attribute__((target("avx2"))) static void philoxUniformsAvx2(
+    PhiloxKey key, std::uint64_t stream, std::uint64_t first, uint nblock,
+    Real* out)
+{
+    const __m256i m0 = _mm256_set1_epi32((int)philoxM0);
+    const __m256i m1 = _mm256_set1_epi32((int)philoxM1);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    alignas(32) std::uint32_t r[4][8];
+    uint b = 0;
+    for (; b + 8 <= nblock; b += 8)
+    {
+        std::uint64_t block = first + b;
+        // the block counter only carries into the high word within a group
+        // if the low word wraps around
+        __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32((int)block), lane);
+        __m256i c1 = _mm256_set1_epi32((int)(block >> 32));
+        if ((std::uint32_t)block > 0xfffffff8u)
+        {
+            for (uint l = 0; l < 8; l++)
+            {
+                r[0][l] = (std::uint32_t)((block + l) >> 32);
+            }
+            c1 = _mm256_load_si256((const __m256i*)r[0]);
+        }
+        __m256i c2 = _mm256_set1_epi32((int)(std::uint32_t)stream);
+        __m256i c3 = _mm256_set1_epi32((int)(std::uint32_t)(stream >> 32));
+        std::uint32_t k0 = key[0];
+        std::uint32_t k1 = key[1];
+        for (uint round = 0; round < 10; round++)
+        {
+            __m256i hi0, lo0, hi1, lo1;
+            mulhilo8(m0, c0, hi0, lo0);
+            mulhilo8(m1, c2, hi1, lo1);
+            c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1),
+                                  _mm256_set1_epi32((int)k0));
+            c1 = lo1;
+            c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3),
+                                  _mm256_set1_epi32((int)k1));
+            c3 = lo0;
+            k0 += philoxW0;
+            k1 += philoxW1;
+        }
+        _mm256_store_si256((__m256i*)r[0], c0);
+        _mm256_store_si256((__m256i*)r[1], c1);
+        _mm256_store_si256((__m256i*)r[2], c2);
+        _mm256_store_si256((__m256i*)r[3], c3);
+        for (uint l = 0; l < 8; l++)
+        {
+            out[2 * (b + l)] = toUniform(r[1][l], r[0][l]);
+            out[2 * (b + l) + 1] = toUniform(r[3][l], r[2][l]);
+        }
+    }
+    philoxUniforms(key, stream, first + b, nblock - b, out + 2 * b);
+}
+
+static bool cpuHasAvx2()
+{
+    static const bool avx2 = []() {
+        __builtin_cpu_init();
+        return (bool)__builtin_cpu_supports("avx2");
+    }();
+    return avx2;
+}
+#endif
+
+PhiloxSampler::PhiloxSampler(std::uint64_t seed, std::uint64_t stream)
+    : _key{(std::uint32_t)seed, (std::uint32_t)(seed >> 32)},
+      _stream(stream),
+      _pos(0),
+      _block{0.0, 0.0}
+{
+}
+
+void PhiloxSampler::loadBlock()
+{
+    auto r = philox4x32(blockCounter(_pos >> 1, _stream), _key);
+    _block[0] = toUniform(r[1], r[0]);
+    _block[1] = toUniform(r[3], r[2]);
+}
+
+void PhiloxSampler::fill(Real* out, uint n)
+{
+    uint i = 0;
+    if (n > 0 && (_pos & 1) == 1)
+    {
+        out[i++] = (*this)();
+    }
+    uint nblock = (n - i) / 2;
+#if defined(__x86_64__)
+    if (cpuHasAvx2())
+    {
+        philoxUniformsAvx2(_key, _stream, _pos >> 1, nblock, out + i);
+    }
+    else
+    {
+        philoxUniforms(_key, _stream, _pos >> 1, nblock, out + i);
+    }
+#else
+    philoxUniforms(_key, _stream, _pos >> 1, nblock, out + i);
+#endif
+    _pos += 2 * (std::uint64_t)nblock;
+    i += 2 * nblock;
+    if (i < n)
+    {
+        out[i] = (*this)();
+    }
+}
+
+void PhiloxSampler::discard(std::uint64_t n)
+{
+    _pos += n;
+    if ((_pos & 1) == 1)
+    {
+        loadBlock();
+    }
+}
+
+PhiloxSampler PhiloxSampler::split(std::uint64_t substream) const
+{
+    return PhiloxSampler(seed(), streamSeed(_stream, substream));
+}
+
+}  // namespace sanity::simulate
@@ -0,0 +1,89 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "type.hpp"
+
+namespace sanity::simulate
+{
+using PhiloxCounter = std::array<std::uint32_t, 4>;
+using PhiloxKey = std::array<std::uint32_t, 2>;
+
+// the Philox4x32-10 bijection of Salmon et al., "Parallel random numbers:
+// as easy as 1, 2, 3"
+PhiloxCounter philox4x32(PhiloxCounter ctr, PhiloxKey key);
+
+// Counter-based uniform sampler on (0, 1). The i-th number of a stream is a
+// pure function of (seed, stream, i): the seed is the Philox key, the
+// stream fills the upper half of the counter and the block index i / 2 the
+// lower half, every block giving two 53-bit uniforms. Streams of one seed
+// therefore never overlap, the state is a few words, and any position can
+// be reached in O(1).
+class PhiloxSampler
+{
+    PhiloxKey _key;
+    std::uint64_t _stream;
+    std::uint64_t _pos;  // index of the next number in the stream
+    Real _block[2];      // the block of _pos if _pos is odd
+
+    void loadBlock();
+
+public:
+    PhiloxSampler(std::uint64_t seed, std::uint64_t stream = 0);
+    Real operator()()
+    {
+        if ((_pos & 1) == 0)
+        {
+            loadBlock();
+        }
+        return _block[_pos++ & 1];
+    }
+    // writes the next n numbers to out, generating whole blocks in bulk
+    void fill(Real* out, uint n);
+    void fill(std::vector<Real>& out) { fill(out.data(), out.size()); }
+    // skips the next n numbers
+    void discard(std::uint64_t n);
+    // a stream of the same seed whose number is hashed from this stream's
+    // and substream, e.g. to give parts of one replication their own numbers
+    PhiloxSampler split(std::uint64_t substream) const;
+
+    std::uint64_t seed() const
+    {
+        return ((std::uint64_t)_key[1] << 32) | _key[0];
+    }
+    std::uint64_t stream() const { return _stream; }
+    std::uint64_t position() const { return _pos; }
+};
+
+// Hands out the numbers of a PhiloxSampler from a buffer that is refilled
+// with PhiloxSampler::fill, for consumers that draw one number at a time
+// such as the GPN firing time samplers. Draws the same sequence as the
+// underlying sampler.
+class BufferedSampler
+{
+    PhiloxSampler _gen;
+    std::vector<Real> _buffer;
+    uint _next;
+
+public:
+    BufferedSampler(PhiloxSampler gen, uint buffer_size = 256)
+        : _gen(std::move(gen)), _buffer(buffer_size), _next(buffer_size)
+    {
+    }
+    BufferedSampler(std::uint64_t seed, std::uint64_t stream = 0,
+                    uint buffer_size = 256)
+        : BufferedSampler(PhiloxSampler(seed, stream), buffer_size)
+    {
+    }
+    Real operator()()
+    {
+        if (_next == _buffer.size())
+        {
+            _gen.fill(_buffer);
+            _next = 0;
+        }
+        return _buffer[_next++];
+    }
+};
+
+}  // namespace sanity::simulate
@@ -1,9 +1,18 @@
 #include "random.hpp"
 #include <cassert>
 #include <cmath>
+#include "stats.hpp"
 
 namespace sanity::simulate
 {
+std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t stream)
+{
+    std::uint64_t z = seed + (stream + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
 Real mean(const std::vector<Real>& samples)
 {
     Real sum = 0;
@@ -99,25 +108,23 @@ Real stdNormDistQuantile(Real p)
     return x;
 }
 
-Interval confidenceInterval(const std::vector<Real>& samples, Real confidence)
+static OnlineStats onlineStats(const std::vector<Real>& samples)
 {
-    if (samples.size() < 10)
+    OnlineStats stats;
+    for (Real x : samples)
     {
-        throw std::invalid_argument(
-            "You need at least 10 samples to compute confidence interval.");
+        stats.add(x);
     }
-    Real mu = mean(samples);
-    Real var = sampleVariance(samples, mu);
-    Real s = std::sqrt(var);
-    Real n = samples.size();
-
-    Real left_p = stdNormDistQuantile((1.0 - confidence) / 2.0);
-    Real half = (-left_p) * s / std::sqrt(n);
+    return stats;
+}
 
-    Interval itv;
-    itv.begin = mu - half;
-    itv.end = mu + half;
+Interval confidenceInterval(const std::vector<Real>& samples, Real confidence)
+{
+    return confidenceInterval(onlineStats(samples), confidence);
+}
 
-    return itv;
+Real relativeHalfWidth(const std::vector<Real>& samples, Real confidence)
+{
+    return relativeHalfWidth(onlineStats(samples), confidence);
 }
 }  // namespace sanity::simulate
@@ -1,4 +1,6 @@
 #pragma once
+#include <cmath>
+#include <cstdint>
 #include <random>
 #include <vector>
 #include "type.hpp"
@@ -12,11 +14,69 @@ class UniformSampler
 
 public:
     UniformSampler() : gen(std::random_device()()), dis(0.0, 1.0) {}
-    UniformSampler(uint seed) : gen(seed), dis(0.0, 1.0) {}
-    UniformSampler(uint seed, Real a, Real b) : gen(seed), dis(a, b) {}
+    UniformSampler(std::uint64_t seed) : gen(seed), dis(0.0, 1.0) {}
+    UniformSampler(std::uint64_t seed, Real a, Real b) : gen(seed), dis(a, b)
+    {
+    }
     Real operator()() { return dis(gen); }
 };
 
+// the seed of random stream number stream derived from a base seed. Seeds
+// of neighbouring streams are scrambled by splitmix64, so that generators
+// seeded with them are statistically independent of each other.
+std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t stream);
+
+// A Poisson(mean) variate drawn with uniform samples on (0, 1): by
+// multiplying uniforms for small means and by the transformed rejection
+// with squeeze (PTRS) of Hormann, "The transformed rejection method for
+// generating Poisson random variables", otherwise.
+template <typename Uniform>
+uint poissonSample(Real mean, Uniform& uniform)
+{
+    if (mean <= 0.0)
+    {
+        return 0;
+    }
+    if (mean < 10.0)
+    {
+        Real limit = std::exp(-mean);
+        Real prod = uniform();
+        uint k = 0;
+        while (prod > limit)
+        {
+            prod *= uniform();
+            k++;
+        }
+        return k;
+    }
+    Real slam = std::sqrt(mean);
+    Real loglam = std::log(mean);
+    Real b = 0.931 + 2.53 * slam;
+    Real a = -0.059 + 0.02483 * b;
+    Real invalpha = 1.1239 + 1.1328 / (b - 3.4);
+    Real vr = 0.9277 - 3.6224 / (b - 2);
+    while (true)
+    {
+        Real u = uniform() - 0.5;
+        Real v = uniform();
+        Real us = 0.5 - std::fabs(u);
+        Real k = std::floor((2 * a / us + b) * u + mean + 0.43);
+        if (us >= 0.07 && v <= vr)
+        {
+            return (uint)k;
+        }
+        if (k < 0 || (us < 0.013 && v > us))
+        {
+            continue;
+        }
+        if (std::log(v) + std::log(invalpha) - std::log(a / (us * us) + b) <=
+            -mean + k * loglam - std::lgamma(k + 1))
+        {
+            return (uint)k;
+        }
+    }
+}
+
 struct Interval
 {
     Real begin;
@@ -33,5 +93,8 @@ Real stdNormDistQuantile(Real quantile);
 
 Interval confidenceInterval(const std::vector<Real>& samples,
                             Real confidence);
+// half width of the confidence interval over the magnitude of its center,
+// infinite if there are too few samples for an interval
+Real relativeHalfWidth(const std::vector<Real>& samples, Real confidence);
 
 }  // namespace sanity::simulate
@@ -0,0 +1,162 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "parallel.hpp"
+#include "stats.hpp"
+#include "type.hpp"
+
+namespace sanity::simulate
+{
+// Replications are grouped into blocks of this many consecutive indices,
+// each recorded by its own copy of the observers. The blocks are merged in
+// index order, so that the reduction does not depend on the thread count.
+constexpr uint replicationBlockSize = 16;
+
+// Runs replications first, ..., last - 1 as runReplications below does,
+// every block starting from a copy of the observers in fresh, and merges
+// their results into result.
+template <typename Simulator, typename ReseedFn, typename... Observers>
+void appendReplications(const Simulator& sim, uint first, uint last,
+                        Real duration, std::uint64_t seed, uint nthread,
+                        const ReseedFn& reseed,
+                        const std::tuple<Observers...>& fresh,
+                        std::tuple<Observers...>& result)
+{
+    assert(first <= last);
+    uint nblock = (last - first + replicationBlockSize - 1) /
+                  replicationBlockSize;
+    nthread = std::min(parallel::threadCount(nthread), std::max(nblock, 1u));
+    std::vector<std::tuple<Observers...>> partial(nblock, fresh);
+    std::vector<Simulator> locals(nthread, sim);
+    auto worker = [&](uint tid, uint block) {
+        Simulator& local = locals[tid];
+        local.clearObservers();
+        std::apply([&](auto&... ob) { (local.addObserver(ob), ...); },
+                   partial[block]);
+        uint begin = first + block * replicationBlockSize;
+        uint end = std::min(begin + replicationBlockSize, last);
+        for (uint i = begin; i < end; i++)
+        {
+            reseed(local, seed, i);
+            local.begin();
+            if (std::isinf(duration))
+            {
+                local.runTillEnd();
+            }
+            else
+            {
+                local.runFor(duration);
+            }
+            local.end();
+        }
+    };
+    parallel::parallelForDynamic(0, nblock, nthread, worker);
+    for (uint block = 0; block < nblock; block++)
+    {
+        std::apply(
+            [&](auto&... res) {
+                std::apply([&](const auto&... ob) { (res.merge(ob), ...); },
+                           partial[block]);
+            },
+            result);
+    }
+}
+
+// Runs nrep independent replications of sim, each simulating duration time
+// units (or until no event is left if duration is infinite), on nthread
+// worker threads (0 means one per hardware thread) and returns the merged
+// observers.
+//
+// Every worker runs on its own copy of sim (the observers attached to sim
+// are not carried over). Before replication i, reseed(sim_copy, seed, i)
+// hands the copy the random stream of replication i, typically
+// PhiloxSampler(seed, i). Every block of replicationBlockSize replications
+// is recorded by its own copy of obs, and the copies are reduced in block
+// order with ob.merge(const Observer& other), which must append the
+// results of other to ob. The samples are therefore those of running
+// replication 0, 1, ..., nrep - 1 in turn. Accumulators merged pairwise,
+// such as OnlineStats, round differently from a single sequential one,
+// but as the blocks do not depend on nthread, every result is identical
+// whatever the thread count.
+template <typename Simulator, typename ReseedFn, typename... Observers>
+std::tuple<Observers...> runReplications(
+    const Simulator& sim, uint nrep, Real duration, std::uint64_t seed,
+    uint nthread, const ReseedFn& reseed, const Observers&... obs)
+{
+    std::tuple<Observers...> fresh(obs...);
+    auto result = fresh;
+    appendReplications(sim, 0, nrep, duration, seed, nthread, reseed, fresh,
+                       result);
+    return result;
+}
+
+struct SequentialOptions
+{
+    // the target of every observer: the half width of the confidence
+    // interval of its mean at most this fraction of the mean
+    Real relativeHalfWidth = 0.05;
+    Real confidence = 0.95;
+    uint minReplications = 30;
+    uint maxReplications = 100000;
+};
+
+template <typename... Observers>
+struct SequentialResult
+{
+    std::tuple<Observers...> observers;
+    uint replications;
+    bool converged;  // whether every target was met within the budget
+};
+
+// Runs replications as runReplications does, in batches, until the
+// stats() of every observer meet the precision target of options or the
+// replication budget is spent. The first batch has minReplications
+// replications; every later one is sized from the worst relative half
+// width so far, assuming it shrinks with the square root of the number of
+// replications, but at most doubles the replications done. Replication i
+// always runs on stream i and the blocks of appendReplications do not
+// depend on nthread, so neither does the result, including the number of
+// replications.
+template <typename Simulator, typename ReseedFn, typename... Observers>
+SequentialResult<Observers...> runUntilPrecise(
+    const Simulator& sim, const SequentialOptions& options, Real duration,
+    std::uint64_t seed, uint nthread, const ReseedFn& reseed,
+    const Observers&... obs)
+{
+    std::tuple<Observers...> fresh(obs...);
+    SequentialResult<Observers...> res{fresh, 0, false};
+    uint budget = options.maxReplications;
+    uint next = std::min(std::max(options.minReplications, 1u), budget);
+    while (next > res.replications)
+    {
+        appendReplications(sim, res.replications, next, duration, seed,
+                           nthread, reseed, fresh, res.observers);
+        res.replications = next;
+        Real worst = 0.0;
+        std::apply(
+            [&](const auto&... ob) {
+                ((worst = std::max(worst,
+                                   relativeHalfWidth(ob.stats(),
+                                                     options.confidence))),
+                 ...);
+            },
+            res.observers);
+        if (worst <= options.relativeHalfWidth)
+        {
+            res.converged = true;
+            break;
+        }
+        Real ratio = worst / options.relativeHalfWidth;
+        Real needed = std::min(res.replications * ratio * ratio,
+                               2.0 * res.replications);
+        next = (uint)std::min(std::ceil(needed), (Real)budget);
+        next = std::min(std::max(next, res.replications + 1), budget);
+    }
+    return res;
+}
+
+}  // namespace sanity::simulate
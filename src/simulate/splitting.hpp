@@ -0,0 +1,146 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "parallel.hpp"
+#include "type.hpp"
+
+namespace sanity::simulate
+{
+struct SplittingOptions
+{
+    // trajectories started from every level
+    uint effort = 1000;
+    // independent runs of the whole scheme, each giving one estimate
+    uint repetitions = 30;
+};
+
+struct SplittingResult
+{
+    // an unbiased estimate of the probability per repetition, e.g. for
+    // confidenceInterval
+    std::vector<Real> estimates;
+    // by level, the fraction of the trajectories started from the level
+    // below (the initial state for the first) that reached it, averaged
+    // over the repetitions. Levels above one that no trajectory reached
+    // count as 0.
+    std::vector<Real> levelProbabilities;
+};
+
+// advances sim until the importance of its state reaches level (true) or
+// no event is left up to time horizon (false)
+template <typename Simulator, typename ImportanceFn>
+bool runToLevel(Simulator& sim, const ImportanceFn& importance, Real level,
+                Real horizon)
+{
+    while (importance(std::as_const(sim).state()) < level)
+    {
+        if (!sim.step(horizon))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Estimates the probability that the importance of the state of sim reaches
+// levels.back() within horizon time units of begin(), for events too rare
+// to be seen by plain replications, by fixed effort multilevel splitting
+// (Garvels, "The splitting method in rare event simulation"). The first
+// stage runs options.effort trajectories from the beginning until they
+// reach levels[0] or time runs out. Every later stage restarts
+// options.effort trajectories, in turn, from copies of the simulator taken
+// when the trajectories of the stage before reached their level, and runs
+// them to the next level. Copies keep the pending events, so timed
+// transitions need not be exponential. The estimate is the product of the
+// fractions of the trajectories that reached their level.
+//
+// Every trajectory gets its own random stream through reseed(sim_copy,
+// seed, stream) before it runs, and the repetitions run on nthread worker
+// threads (0 means one per hardware thread), so the result does not depend
+// on nthread. importance(const State&) must not decrease on the way to the
+// event of interest; levels must increase and are best spaced so that
+// every stage succeeds with a probability of about 0.1 to 0.5.
+template <typename Simulator, typename ImportanceFn, typename ReseedFn>
+SplittingResult fixedEffortSplitting(const Simulator& sim,
+                                     const ImportanceFn& importance,
+                                     const std::vector<Real>& levels,
+                                     Real horizon,
+                                     const SplittingOptions& options,
+                                     std::uint64_t seed, uint nthread,
+                                     const ReseedFn& reseed)
+{
+    if (levels.empty())
+    {
+        throw std::invalid_argument("Need at least one level.");
+    }
+    for (uint k = 1; k < levels.size(); k++)
+    {
+        if (!(levels[k - 1] < levels[k]))
+        {
+            throw std::invalid_argument("Levels must be increasing.");
+        }
+    }
+    if (options.effort == 0 || options.repetitions == 0)
+    {
+        throw std::invalid_argument(
+            "Effort and repetitions must be positive.");
+    }
+    const uint nlevel = levels.size();
+    const uint effort = options.effort;
+    std::vector<Real> estimates(options.repetitions);
+    std::vector<Real> fractions((std::uint64_t)options.repetitions * nlevel,
+                                0.0);
+    auto worker = [&](uint, uint begin, uint end) {
+        std::vector<Simulator> starts;
+        std::vector<Simulator> reached;
+        for (uint r = begin; r < end; r++)
+        {
+            Real estimate = 1.0;
+            starts.clear();
+            for (uint k = 0; k < nlevel && estimate > 0.0; k++)
+            {
+                reached.clear();
+                for (uint j = 0; j < effort; j++)
+                {
+                    std::uint64_t stream =
+                        ((std::uint64_t)r * nlevel + k) * effort + j;
+                    Simulator traj = k == 0 ? sim : starts[j % starts.size()];
+                    reseed(traj, seed, stream);
+                    if (k == 0)
+                    {
+                        traj.clearObservers();
+                        traj.begin();
+                    }
+                    if (runToLevel(traj, importance, levels[k], horizon))
+                    {
+                        reached.push_back(std::move(traj));
+                    }
+                }
+                Real fraction = (Real)reached.size() / effort;
+                fractions[(std::uint64_t)r * nlevel + k] = fraction;
+                estimate *= fraction;
+                std::swap(starts, reached);
+            }
+            estimates[r] = estimate;
+        }
+    };
+    nthread = std::min(parallel::threadCount(nthread), options.repetitions);
+    parallel::parallelFor(0, options.repetitions, nthread, worker);
+
+    SplittingResult res{estimates, std::vector<Real>(nlevel, 0.0)};
+    for (uint r = 0; r < options.repetitions; r++)
+    {
+        for (uint k = 0; k < nlevel; k++)
+        {
+            res.levelProbabilities[k] +=
+                fractions[(std::uint64_t)r * nlevel + k] /
+                options.repetitions;
+        }
+    }
+    return res;
+}
+
+}  // namespace sanity::simulate
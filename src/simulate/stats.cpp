@@ -0,0 +1,167 @@
+#include "stats.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace sanity::simulate
+{
+void OnlineStats::merge(const OnlineStats& other)
+{
+    if (other._count == 0)
+    {
+        return;
+    }
+    if (_count == 0)
+    {
+        *this = other;
+        return;
+    }
+    Real n1 = _count;
+    Real n2 = other._count;
+    Real delta = other._mean - _mean;
+    _count += other._count;
+    _mean += delta * n2 / (n1 + n2);
+    _m2 += other._m2 + delta * delta * n1 * n2 / (n1 + n2);
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+}
+
+Interval confidenceInterval(const OnlineStats& stats, Real confidence)
+{
+    if (stats.count() < 10)
+    {
+        throw std::invalid_argument(
+            "You need at least 10 samples to compute confidence interval.");
+    }
+    Real s = std::sqrt(stats.sampleVariance());
+    Real left_p = stdNormDistQuantile((1.0 - confidence) / 2.0);
+    Real half = (-left_p) * s / std::sqrt((Real)stats.count());
+    return {stats.mean() - half, stats.mean() + half};
+}
+
+Real relativeHalfWidth(const OnlineStats& stats, Real confidence)
+{
+    if (stats.count() < 10)
+    {
+        return INFINITY;
+    }
+    auto itv = confidenceInterval(stats, confidence);
+    Real half = (itv.end - itv.begin) / 2.0;
+    if (half == 0.0)
+    {
+        return 0.0;
+    }
+    return half / std::fabs(itv.center());
+}
+
+QuantileSketch::QuantileSketch(uint capacity)
+    : _capacity(capacity), _count(0), _levels(), _odd()
+{
+    if (capacity < 2)
+    {
+        throw std::invalid_argument("Sketch capacity must be at least 2.");
+    }
+}
+
+void QuantileSketch::compact(uint h)
+{
+    if (h + 1 == _levels.size())
+    {
+        _levels.emplace_back();
+        _odd.push_back(false);
+    }
+    auto& level = _levels[h];
+    std::sort(level.begin(), level.end());
+    // an odd sample out stays behind to keep the total weight
+    Real left = 0;
+    bool has_left = level.size() % 2 == 1;
+    if (has_left)
+    {
+        left = level.back();
+        level.pop_back();
+    }
+    for (uint i = _odd[h] ? 1 : 0; i < level.size(); i += 2)
+    {
+        _levels[h + 1].push_back(level[i]);
+    }
+    _odd[h] = !_odd[h];
+    level.clear();
+    if (has_left)
+    {
+        level.push_back(left);
+    }
+}
+
+void QuantileSketch::add(Real x)
+{
+    if (_levels.empty())
+    {
+        _levels.emplace_back();
+        _odd.push_back(false);
+    }
+    _levels[0].push_back(x);
+    _count++;
+    for (uint h = 0; h < _levels.size() && _levels[h].size() >= _capacity;
+         h++)
+    {
+        compact(h);
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    while (_levels.size() < other._levels.size())
+    {
+        _levels.emplace_back();
+        _odd.push_back(false);
+    }
+    for (uint h = 0; h < other._levels.size(); h++)
+    {
+        _levels[h].insert(_levels[h].end(), other._levels[h].begin(),
+                          other._levels[h].end());
+    }
+    _count += other._count;
+    for (uint h = 0; h < _levels.size(); h++)
+    {
+        if (_levels[h].size() >= _capacity)
+        {
+            compact(h);
+        }
+    }
+}
+
+Real QuantileSketch::quantile(Real q) const
+{
+    if (_count == 0)
+    {
+        throw std::invalid_argument("The sketch has no samples.");
+    }
+    assert(q >= 0.0 && q <= 1.0);
+    std::vector<std::pair<Real, Real>> items;  // sample, weight
+    Real total = 0;
+    for (uint h = 0; h < _levels.size(); h++)
+    {
+        Real weight = std::ldexp(1.0, (int)h);
+        for (Real x : _levels[h])
+        {
+            items.emplace_back(x, weight);
+            total += weight;
+        }
+    }
+    std::sort(items.begin(), items.end());
+    Real rank = q * total;
+    Real acc = 0;
+    for (const auto& [x, weight] : items)
+    {
+        acc += weight;
+        if (acc >= rank)
+        {
+            return x;
+        }
+    }
+    return items.back().first;
+}
+
+}  // namespace sanity::simulate
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "random.hpp"
+#include "type.hpp"
+
+namespace sanity::simulate
+{
+// Count, mean and variance of a stream of samples in constant memory, by
+// Welford's update. Two accumulators merge exactly (Chan et al.), so that
+// workers can reduce their partial results.
+class OnlineStats
+{
+    std::uint64_t _count = 0;
+    Real _mean = 0.0;
+    Real _m2 = 0.0;  // sum of squared deviations from the mean
+    Real _min = INFINITY;
+    Real _max = -INFINITY;
+
+public:
+    void add(Real x)
+    {
+        _count++;
+        Real delta = x - _mean;
+        _mean += delta / _count;
+        _m2 += delta * (x - _mean);
+        _min = std::min(_min, x);
+        _max = std::max(_max, x);
+    }
+    void merge(const OnlineStats& other);
+    std::uint64_t count() const { return _count; }
+    Real mean() const { return _mean; }
+    Real variance() const { return _m2 / _count; }
+    Real sampleVariance() const { return _m2 / (_count - 1); }
+    Real min() const { return _min; }
+    Real max() const { return _max; }
+};
+
+Interval confidenceInterval(const OnlineStats& stats, Real confidence);
+Real relativeHalfWidth(const OnlineStats& stats, Real confidence);
+
+// Approximate quantiles of a stream in O(capacity * log(n / capacity))
+// memory, by a compactor hierarchy as in Karnin, Lang and Liberty,
+// "Optimal quantile approximation in streams", with equal capacities and
+// alternating instead of random offsets, so that results are reproducible.
+// Level h holds samples of weight 2^h; a full level is sorted and every
+// other sample moves up. The rank error is about log2(n / capacity) /
+// capacity of n. Sketches merge level by level.
+class QuantileSketch
+{
+    uint _capacity;
+    std::uint64_t _count;
+    std::vector<std::vector<Real>> _levels;
+    std::vector<bool> _odd;  // the offset of the next compaction by level
+
+    void compact(uint h);
+
+public:
+    QuantileSketch(uint capacity = 128);
+    void add(Real x);
+    void merge(const QuantileSketch& other);
+    std::uint64_t count() const { return _count; }
+    // the sample of approximate rank q * count() for q in [0, 1]; throws
+    // std::invalid_argument if the sketch is empty
+    Real quantile(Real q) const;
+};
+
+// The samples an observer records: every sample if keepSamples is on (the
+// default), their OnlineStats always, and a QuantileSketch if
+// sketchQuantiles is on. Turning off the samples keeps the memory of an
+// observer constant however many replications it sees.
+class SampleRecorder
+{
+    bool _keep_samples = true;
+    bool _sketch_quantiles = false;
+    std::vector<Real> _samples;
+    OnlineStats _stats;
+    QuantileSketch _quantiles;
+
+public:
+    void add(Real x)
+    {
+        if (_keep_samples)
+        {
+            _samples.push_back(x);
+        }
+        _stats.add(x);
+        if (_sketch_quantiles)
+        {
+            _quantiles.add(x);
+        }
+    }
+    // appends the samples of other
+    void merge(const SampleRecorder& other)
+    {
+        _samples.insert(_samples.end(), other._samples.begin(),
+                        other._samples.end());
+        _stats.merge(other._stats);
+        _quantiles.merge(other._quantiles);
+    }
+    void keepSamples(bool keep) { _keep_samples = keep; }
+    void sketchQuantiles(bool sketch) { _sketch_quantiles = sketch; }
+    const std::vector<Real>& samples() const { return _samples; }
+    const OnlineStats& stats() const { return _stats; }
+    const QuantileSketch& quantiles() const { return _quantiles; }
+};
+
+}  // namespace sanity::simulate
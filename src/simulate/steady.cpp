@@ -0,0 +1,78 @@
+#include "steady.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace sanity::simulate
+{
+uint mser5Truncation(const std::vector<Real>& obs)
+{
+    const uint group = 5;
+    uint ngroup = (uint)obs.size() / group;
+    if (ngroup < 2)
+    {
+        return 0;
+    }
+    std::vector<Real> means(ngroup);
+    for (uint g = 0; g < ngroup; g++)
+    {
+        Real sum = 0;
+        for (uint i = 0; i < group; i++)
+        {
+            sum += obs[g * group + i];
+        }
+        means[g] = sum / group;
+    }
+    // walk d down from the middle, keeping the sums of the groups after d
+    Real sum = 0;
+    Real sum2 = 0;
+    for (uint g = ngroup / 2; g < ngroup; g++)
+    {
+        sum += means[g];
+        sum2 += means[g] * means[g];
+    }
+    uint best = ngroup / 2;
+    Real best_mser = INFINITY;
+    for (uint d = ngroup / 2 + 1; d-- > 0;)
+    {
+        if (d < ngroup / 2)
+        {
+            sum += means[d];
+            sum2 += means[d] * means[d];
+        }
+        Real n = ngroup - d;
+        Real mser = std::max(sum2 - sum * sum / n, 0.0) / (n * n);
+        if (mser <= best_mser)
+        {
+            best_mser = mser;
+            best = d;
+        }
+    }
+    return best * group;
+}
+
+std::vector<Real> batchMeans(const std::vector<Real>& obs, uint first,
+                             uint nbatch)
+{
+    assert(nbatch > 0);
+    uint count = first < obs.size() ? (uint)obs.size() - first : 0;
+    if (count < nbatch)
+    {
+        return std::vector<Real>(obs.end() - count, obs.end());
+    }
+    uint size = count / nbatch;
+    uint start = (uint)obs.size() - size * nbatch;
+    std::vector<Real> means(nbatch);
+    for (uint b = 0; b < nbatch; b++)
+    {
+        Real sum = 0;
+        for (uint i = 0; i < size; i++)
+        {
+            sum += obs[start + b * size + i];
+        }
+        means[b] = sum / size;
+    }
+    return means;
+}
+
+}  // namespace sanity::simulate
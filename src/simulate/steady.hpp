@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+#include "type.hpp"
+
+namespace sanity::simulate
+{
+// Output analysis of one long steady-state run, whose observations are
+// averages over consecutive intervals of equal length.
+
+// the number of leading observations to discard as warm-up by the MSER-5
+// rule of White et al., "A comparison of five steady-state truncation
+// heuristics": the observations are averaged in groups of 5 and the
+// truncation point d minimizing the squared standard error of the mean of
+// the groups after d is chosen among the first half of the groups.
+uint mser5Truncation(const std::vector<Real>& obs);
+
+// the means of nbatch batches of equal size formed from obs[first], ...,
+// obs[obs.size() - 1]. Observations that do not fill a whole batch are
+// dropped from the front, away from the end of the warm-up. If there are
+// fewer than nbatch observations, every observation is a batch.
+std::vector<Real> batchMeans(const std::vector<Real>& obs, uint first,
+                             uint nbatch);
+
+}  // namespace sanity::simulate
@@ -0,0 +1,54 @@
+#include "sumtree.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace sanity::simulate
+{
+SumTree::SumTree(uint size) : _size(size), _leaf0(1), _nodes()
+{
+    while (_leaf0 < size)
+    {
+        _leaf0 *= 2;
+    }
+    _nodes.assign(2 * _leaf0, 0.0);
+}
+
+void SumTree::set(uint i, Real weight)
+{
+    assert(i < _size);
+    assert(weight >= 0.0);
+    uint node = _leaf0 + i;
+    _nodes[node] = weight;
+    for (node /= 2; node > 0; node /= 2)
+    {
+        _nodes[node] = _nodes[2 * node] + _nodes[2 * node + 1];
+    }
+}
+
+void SumTree::clear()
+{
+    std::fill(_nodes.begin(), _nodes.end(), 0.0);
+}
+
+uint SumTree::find(Real x) const
+{
+    assert(total() > 0.0);
+    uint node = 1;
+    while (node < _leaf0)
+    {
+        Real left = _nodes[2 * node];
+        // rounding may push x past the total, or onto an empty subtree
+        if ((x < left || _nodes[2 * node + 1] == 0.0) && left > 0.0)
+        {
+            node = 2 * node;
+        }
+        else
+        {
+            x -= left;
+            node = 2 * node + 1;
+        }
+    }
+    return node - _leaf0;
+}
+
+}  // namespace sanity::simulate
@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+#include "type.hpp"
+
+namespace sanity::simulate
+{
+// Binary tree over n nonnegative weights whose inner nodes hold the sums of
+// their subtrees. Setting a weight and drawing an index with probability
+// proportional to its weight both take O(log n). Sums are recomputed from
+// the children on every update, so no rounding error accumulates.
+class SumTree
+{
+    uint _size;
+    uint _leaf0;               // node of weight 0
+    std::vector<Real> _nodes;  // node i has children 2i and 2i + 1
+
+public:
+    SumTree(uint size = 0);
+    uint size() const { return _size; }
+    Real total() const { return _nodes[1]; }
+    Real weight(uint i) const { return _nodes[_leaf0 + i]; }
+    void set(uint i, Real weight);
+    // sets every weight to 0
+    void clear();
+    // the index i with w(0) + ... + w(i - 1) <= x < w(0) + ... + w(i),
+    // skipping zero weights; x needs to be in [0, total())
+    uint find(Real x) const;
+};
+
+}  // namespace sanity::simulate
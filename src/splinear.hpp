@@ -1,7 +1,13 @@
 #pragma once
 
+#include "splinear/batch.hpp"
+#include "splinear/compact.hpp"
 #include "splinear/eigen.hpp"
+#include "splinear/kronecker.hpp"
 #include "splinear/matrix.hpp"
+#include "splinear/mixed.hpp"
 #include "splinear/oper.hpp"
+#include "splinear/pattern.hpp"
+#include "splinear/sell.hpp"
 #include "splinear/solve.hpp"
 #include "splinear/utils.hpp"
@@ -0,0 +1,333 @@
+#include "batch.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace sanity::splinear
+{
+using namespace linear;
+
+SpmatrixBatch spmatrixBatch(const SpmatrixPattern& pattern,
+                            const std::vector<std::vector<Real>>& params)
+{
+    const auto& A = pattern.matrix;
+    uint nlane = params.size();
+    assert(nlane > 0);
+    SpmatrixBatch batch(A.nrow, A.ncol, A.format, nlane);
+    batch.ptr = A.ptr;
+    batch.idx = A.idx;
+    batch.val.resize(A.val.size() * nlane);
+    auto lane_mat = A;
+    for (uint lane = 0; lane < nlane; lane++)
+    {
+        updateValues(lane_mat, pattern.valueMap, params[lane]);
+        for (uint k = 0; k < lane_mat.val.size(); k++)
+        {
+            batch.val[k * nlane + lane] = lane_mat.val[k];
+        }
+    }
+    return batch;
+}
+
+SpmatrixBatch spmatrixBatch(const Spmatrix& A)
+{
+    SpmatrixBatch batch(A.nrow, A.ncol, A.format, 1);
+    batch.ptr = A.ptr;
+    batch.idx = A.idx;
+    batch.val = A.val;
+    return batch;
+}
+
+// Calls f(l0, W) for groups [l0, l0 + W) of active lanes, W in 8, 4, 2, 1.
+template <typename F>
+static void forLaneGroups(const std::vector<char>& active, F f)
+{
+    uint K = active.size();
+    uint l = 0;
+    while (l < K)
+    {
+        if (!active[l])
+        {
+            l++;
+            continue;
+        }
+        uint end = l;
+        while (end < K && active[end])
+        {
+            end++;
+        }
+        while (l < end)
+        {
+            uint n = end - l;
+            uint W = n >= 8 ? 8 : n >= 4 ? 4 : n >= 2 ? 2 : 1;
+            f(l, W);
+            l += W;
+        }
+    }
+}
+
+// the values of nonzero k for the lanes starting at l0
+template <bool Shared>
+static const Real* laneVal(const SpmatrixBatch& A, uint k, uint l0)
+{
+    return A.val.data() + (Shared ? k : k * A.nlane + l0);
+}
+
+// lanes [l0, l0 + W). Shared: one set of values for all the lanes
+template <uint W, bool Shared>
+static void dotLanes(const SpmatrixBatch& A, MatrixConstView V,
+                     MatrixMutableView X, uint l0)
+{
+    const Real* v = &V(0, 0) + l0;
+    Real* x = &X(0, 0) + l0;
+    for (uint i = 0; i < A.nrow; i++)
+    {
+        Real sum[W] = {};
+        for (uint k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+        {
+            const Real* vj = v + A.idx[k] * V.ldim();
+            const Real* a = laneVal<Shared>(A, k, l0);
+            for (uint lane = 0; lane < W; lane++)
+            {
+                sum[lane] += a[Shared ? 0 : lane] * vj[lane];
+            }
+        }
+        Real* xi = x + i * X.ldim();
+        for (uint lane = 0; lane < W; lane++)
+        {
+            xi[lane] = sum[lane];
+        }
+    }
+}
+
+template <bool Shared>
+static void dotT(const SpmatrixBatch& A, MatrixConstView V,
+                 MatrixMutableView X, const std::vector<char>& active)
+{
+    forLaneGroups(active, [&](uint l0, uint W) {
+        switch (W)
+        {
+            case 8:
+                dotLanes<8, Shared>(A, V, X, l0);
+                break;
+            case 4:
+                dotLanes<4, Shared>(A, V, X, l0);
+                break;
+            case 2:
+                dotLanes<2, Shared>(A, V, X, l0);
+                break;
+            default:
+                dotLanes<1, Shared>(A, V, X, l0);
+                break;
+        }
+    });
+}
+
+void dot(const SpmatrixBatch& A, MatrixConstView V, MatrixMutableView X)
+{
+    dot(A, V, X, std::vector<char>(X.ncol(), 1));
+}
+
+void dot(const SpmatrixBatch& A, MatrixConstView V, MatrixMutableView X,
+         const std::vector<char>& active)
+{
+    assert(A.format == Spmatrix::RowCompressed);
+    assert(A.ncol == V.nrow());
+    assert(A.nrow == X.nrow());
+    assert(V.ncol() == X.ncol());
+    assert(A.nlane == 1 || A.nlane == X.ncol());
+    assert(active.size() == X.ncol());
+    if (A.nrow == 0)
+    {
+        return;
+    }
+    if (A.nlane == 1)
+    {
+        dotT<true>(A, V, X, active);
+    }
+    else
+    {
+        dotT<false>(A, V, X, active);
+    }
+}
+
+namespace
+{
+struct SweepArgs
+{
+    const SpmatrixBatch& A;
+    MatrixMutableView X;
+    const MatrixConstView* B;       // nullptr for zero right hand sides
+    const MatrixMutableView* prev;  // nullptr if not saved
+    Real w;
+    BatchSweepStats& stats;
+};
+}  // namespace
+
+// One sweep over lanes [l0, l0 + W). The per-lane state lives in fixed
+// size arrays, so the lane loops have compile time bounds.
+template <uint W, bool Shared, bool HasRhs, bool SavePrev>
+static void sorSweepLanes(const SweepArgs& s, uint l0)
+{
+    const auto& A = s.A;
+    const Real w = s.w;
+    Real* x = &s.X(0, 0) + l0;
+    const uint ldx = s.X.ldim();
+    const Real* b = HasRhs ? &(*s.B)(0, 0) + l0 : nullptr;
+    const uint ldb = HasRhs ? s.B->ldim() : 0;
+    Real* prev = SavePrev ? &(*s.prev)(0, 0) + l0 : nullptr;
+    const uint ldp = SavePrev ? s.prev->ldim() : 0;
+    Real change[W] = {};
+    Real old_norm[W] = {};
+    Real new_norm[W] = {};
+    for (uint i = 0; i < A.nrow; i++)
+    {
+        Real residual[W];
+        Real a_ii[W] = {};
+        for (uint lane = 0; lane < W; lane++)
+        {
+            residual[lane] = HasRhs ? b[i * ldb + lane] : 0.0;
+        }
+        for (uint k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+        {
+            uint j = A.idx[k];
+            const Real* a = laneVal<Shared>(A, k, l0);
+            if (j == i)  // diag
+            {
+                for (uint lane = 0; lane < W; lane++)
+                {
+                    a_ii[lane] = a[Shared ? 0 : lane];
+                }
+            }
+            else
+            {  // non diag
+                const Real* xj = x + j * ldx;
+                for (uint lane = 0; lane < W; lane++)
+                {
+                    residual[lane] -= a[Shared ? 0 : lane] * xj[lane];
+                }
+            }
+        }
+        Real* xi = x + i * ldx;
+        for (uint lane = 0; lane < W; lane++)
+        {
+            Real old = xi[lane];
+            if (SavePrev)
+            {
+                prev[i * ldp + lane] = old;
+            }
+            Real next = w * residual[lane] / a_ii[lane] + (1 - w) * old;
+            change[lane] = std::max(change[lane], std::abs(next - old));
+            old_norm[lane] += std::abs(old);
+            new_norm[lane] += std::abs(next);
+            xi[lane] = next;
+        }
+    }
+    for (uint lane = 0; lane < W; lane++)
+    {
+        s.stats.change[l0 + lane] = change[lane];
+        s.stats.oldNorm[l0 + lane] = old_norm[lane];
+        s.stats.newNorm[l0 + lane] = new_norm[lane];
+    }
+}
+
+template <bool Shared, bool HasRhs, bool SavePrev>
+static void sorSweepT(const SweepArgs& s, const std::vector<char>& active)
+{
+    forLaneGroups(active, [&](uint l0, uint W) {
+        switch (W)
+        {
+            case 8:
+                sorSweepLanes<8, Shared, HasRhs, SavePrev>(s, l0);
+                break;
+            case 4:
+                sorSweepLanes<4, Shared, HasRhs, SavePrev>(s, l0);
+                break;
+            case 2:
+                sorSweepLanes<2, Shared, HasRhs, SavePrev>(s, l0);
+                break;
+            default:
+                sorSweepLanes<1, Shared, HasRhs, SavePrev>(s, l0);
+                break;
+        }
+    });
+}
+
+template <bool HasRhs, bool SavePrev>
+static void sorSweepShared(const SweepArgs& s,
+                           const std::vector<char>& active)
+{
+    assert(s.A.format == Spmatrix::RowCompressed);
+    assert(s.A.nrow == s.A.ncol);
+    assert(s.A.nrow == s.X.nrow());
+    assert(s.A.nlane == 1 || s.A.nlane == s.X.ncol());
+    assert(active.size() == s.X.ncol());
+    assert(s.stats.change.size() == s.X.ncol());
+    if (s.A.nrow == 0)
+    {
+        return;
+    }
+    if (s.A.nlane == 1)
+    {
+        sorSweepT<true, HasRhs, SavePrev>(s, active);
+    }
+    else
+    {
+        sorSweepT<false, HasRhs, SavePrev>(s, active);
+    }
+}
+
+void sorSweep(const SpmatrixBatch& A, MatrixMutableView X, MatrixConstView B,
+              Real w, const std::vector<char>& active, BatchSweepStats& stats)
+{
+    assert(B.nrow() == X.nrow() && B.ncol() == X.ncol());
+    sorSweepShared<true, false>({A, X, &B, nullptr, w, stats}, active);
+}
+
+void sorSweep(const SpmatrixBatch& A, MatrixMutableView X, Real w,
+              const std::vector<char>& active, BatchSweepStats& stats,
+              const MatrixMutableView* X_prev)
+{
+    if (X_prev)
+    {
+        assert(X_prev->nrow() == X.nrow() && X_prev->ncol() == X.ncol());
+        sorSweepShared<false, true>({A, X, nullptr, X_prev, w, stats},
+                                    active);
+    }
+    else
+    {
+        sorSweepShared<false, false>({A, X, nullptr, nullptr, w, stats},
+                                     active);
+    }
+}
+
+std::vector<IterationResult> solveSorBatch(const SpmatrixBatch& A,
+                                           MatrixMutableView X,
+                                           MatrixConstView B, Real w,
+                                           Real tol, uint max_iter)
+{
+    const uint K = X.ncol();
+    std::vector<IterationResult> results(K, {NAN, 0});
+    std::vector<char> active(K, 1);
+    BatchSweepStats stats(K);
+    uint nactive = K;
+    for (uint iter = 1; iter <= max_iter && nactive > 0; iter++)
+    {
+        sorSweep(A, X, B, w, active, stats);
+        for (uint lane = 0; lane < K; lane++)
+        {
+            if (active[lane])
+            {
+                results[lane] = {stats.change[lane], iter};
+                if (stats.change[lane] < tol)
+                {
+                    active[lane] = 0;
+                    nactive -= 1;
+                }
+            }
+        }
+    }
+    return results;
+}
+
+}  // namespace sanity::splinear
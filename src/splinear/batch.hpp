@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include "linear.hpp"
+#include "matrix.hpp"
+#include "pattern.hpp"
+#include "type.hpp"
+
+namespace sanity::splinear
+{
+// nlane matrices with the same sparsity pattern, e.g. one rate matrix per
+// parameter point. The values of one nonzero are adjacent:
+// val[k * nlane + lane], so that one index load serves every lane. With
+// nlane == 1 the single matrix is shared by all the lanes of a batch.
+//
+// Vectors of a batch are stored as the rows of a row-major matrix (one
+// column per lane), i.e. also interleaved.
+struct SpmatrixBatch
+{
+    Spmatrix::Format format;
+    std::vector<uint> ptr;
+    std::vector<uint> idx;
+    std::vector<Real> val;
+    uint nrow;
+    uint ncol;
+    uint nlane;
+    SpmatrixBatch(uint nrow, uint ncol, Spmatrix::Format format, uint nlane)
+        : format(format), nrow(nrow), ncol(ncol), nlane(nlane)
+    {
+    }
+};
+
+// one lane per parameter vector
+SpmatrixBatch spmatrixBatch(const SpmatrixPattern& pattern,
+                            const std::vector<std::vector<Real>>& params);
+// a single shared lane
+SpmatrixBatch spmatrixBatch(const Spmatrix& A);
+
+// X = AV, lane by lane. A needs to be row compressed.
+void dot(const SpmatrixBatch& A, linear::MatrixConstView V,
+         linear::MatrixMutableView X);
+// only for the lanes with active[lane] != 0, the others are not touched
+void dot(const SpmatrixBatch& A, linear::MatrixConstView V,
+         linear::MatrixMutableView X, const std::vector<char>& active);
+
+// Per-lane results of a batched sweep, only written for the active lanes.
+// Allocate it once and pass it to every sweep.
+struct BatchSweepStats
+{
+    std::vector<Real> change;   // max |new - old| of X
+    std::vector<Real> oldNorm;  // L1 norm of X before the sweep
+    std::vector<Real> newNorm;  // L1 norm of X after the sweep
+    explicit BatchSweepStats(uint nlane)
+        : change(nlane), oldNorm(nlane), newNorm(nlane)
+    {
+    }
+};
+
+// One SOR sweep for AX = B. Lanes with active[lane] == 0 are skipped, the
+// active ones are processed in contiguous groups of up to 8 lanes.
+void sorSweep(const SpmatrixBatch& A, linear::MatrixMutableView X,
+              linear::MatrixConstView B, Real w,
+              const std::vector<char>& active, BatchSweepStats& stats);
+// One SOR sweep for AX = 0. If X_prev is given, the old values of the
+// active lanes are saved there on the way.
+void sorSweep(const SpmatrixBatch& A, linear::MatrixMutableView X, Real w,
+              const std::vector<char>& active, BatchSweepStats& stats,
+              const linear::MatrixMutableView* X_prev = nullptr);
+
+// SOR for every lane at once. A lane stops being updated once it
+// converges, and the iteration stops when every lane has converged.
+std::vector<IterationResult> solveSorBatch(const SpmatrixBatch& A,
+                                           linear::MatrixMutableView X,
+                                           linear::MatrixConstView B, Real w,
+                                           Real tol, uint max_iter);
+
+}  // namespace sanity::splinear
@@ -0,0 +1,44 @@
+#include "compact.hpp"
+
+namespace sanity::splinear
+{
+SpmatrixCompact spmatrix2compact(const Spmatrix& spmat)
+{
+    SpmatrixCompact cmat(spmat.nrow, spmat.ncol, spmat.format);
+    uint n =
+        spmat.format == Spmatrix::RowCompressed ? spmat.nrow : spmat.ncol;
+    cmat.ptr.reserve(n + 1);
+    cmat.delta.reserve(spmat.idx.size());
+    cmat.val.reserve(spmat.val.size());
+    cmat.ptr.push_back(0);
+    for (uint i = 0; i < n; i++)
+    {
+        uint prev = i;
+        for (uint k = spmat.ptr[i]; k < spmat.ptr[i + 1]; k++)
+        {
+            long dist = (long)spmat.idx[k] - (long)prev;
+            prev = spmat.idx[k];
+            if (dist > SpmatrixCompact::farIndex && dist <= INT16_MAX)
+            {
+                cmat.delta.push_back((std::int16_t)dist);
+                cmat.val.push_back(spmat.val[k]);
+            }
+            else
+            {
+                cmat.delta.push_back(SpmatrixCompact::farIndex);
+                cmat.delta.push_back(
+                    (std::int16_t)(std::uint16_t)(spmat.idx[k] & 0xffff));
+                cmat.delta.push_back(
+                    (std::int16_t)(std::uint16_t)(spmat.idx[k] >> 16));
+                cmat.val.push_back(spmat.val[k]);
+                cmat.val.push_back(0.0);
+                cmat.val.push_back(0.0);
+                cmat.nfar++;
+            }
+        }
+        cmat.ptr.push_back((uint)cmat.delta.size());
+    }
+    return cmat;
+}
+
+}  // namespace sanity::splinear
@@ -0,0 +1,99 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "matrix.hpp"
+#include "type.hpp"
+
+namespace sanity::splinear
+{
+// Compressed sparse storage with 16 bit indices. The first nonzero of row
+// (or column) i stores the signed distance of its index to i, every further
+// nonzero the distance to the previous index. A distance that does not fit
+// is written as farIndex followed by the low and the high half of the full
+// index; val is padded with two zeros at those positions so that ptr
+// addresses delta and val alike. No per-row data besides ptr is kept.
+struct SpmatrixCompact
+{
+    static constexpr std::int16_t farIndex = INT16_MIN;
+    Spmatrix::Format format;
+    std::vector<uint> ptr;
+    std::vector<std::int16_t> delta;
+    std::vector<Real> val;
+    uint nrow;
+    uint ncol;
+    uint nfar;  // number of nonzeros stored with an escape
+    SpmatrixCompact(uint nrow, uint ncol, Spmatrix::Format format)
+        : format(format), nrow(nrow), ncol(ncol), nfar(0)
+    {
+    }
+    // bytes spent on ptr and delta, to compare with the uint indices of
+    // Spmatrix
+    std::size_t indexBytes() const
+    {
+        return ptr.size() * sizeof(uint) + delta.size() * sizeof(delta[0]);
+    }
+};
+
+SpmatrixCompact spmatrix2compact(const Spmatrix& spmat);
+
+inline uint compactFarIndex(const std::int16_t* delta)
+{
+    return (uint)(std::uint16_t)delta[1] |
+           ((uint)(std::uint16_t)delta[2] << 16);
+}
+
+class SpmatrixCompactConstIterator
+{
+    const std::int16_t* _delta;
+    const std::int16_t* _delta_end;
+    const Real* _val;
+    uint _base;
+
+public:
+    SpmatrixCompactConstIterator(const std::int16_t* delta,
+                                 const std::int16_t* delta_end,
+                                 const Real* val, uint base)
+        : _delta(delta), _delta_end(delta_end), _val(val), _base(base)
+    {
+    }
+    Real val() const { return *_val; }
+    uint idx() const
+    {
+        return *_delta == SpmatrixCompact::farIndex
+                   ? compactFarIndex(_delta)
+                   : (uint)((int)_base + *_delta);
+    }
+    uint col() const { return idx(); }
+    uint row() const { return idx(); }
+    bool end() const { return _delta == _delta_end; }
+    void nextNonzero()
+    {
+        _base = idx();
+        uint step = *_delta == SpmatrixCompact::farIndex ? 3 : 1;
+        _delta += step;
+        _val += step;
+    }
+};
+
+inline SpmatrixCompactConstIterator initRowIter(const SpmatrixCompact& spmat,
+                                                uint row)
+{
+    assert(spmat.format == Spmatrix::RowCompressed);
+    return SpmatrixCompactConstIterator(
+        spmat.delta.data() + spmat.ptr[row],
+        spmat.delta.data() + spmat.ptr[row + 1],
+        spmat.val.data() + spmat.ptr[row], row);
+}
+
+inline SpmatrixCompactConstIterator initColIter(const SpmatrixCompact& spmat,
+                                                uint col)
+{
+    assert(spmat.format == Spmatrix::ColCompressed);
+    return SpmatrixCompactConstIterator(
+        spmat.delta.data() + spmat.ptr[col],
+        spmat.delta.data() + spmat.ptr[col + 1],
+        spmat.val.data() + spmat.ptr[col], col);
+}
+
+}  // namespace sanity::splinear
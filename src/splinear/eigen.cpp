@@ -1,8 +1,208 @@
 #include "eigen.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include "oper.hpp"
 
 namespace sanity::splinear
 {
 using namespace linear;
 
+std::vector<Complex> arnoldiEigenvalues(
+    const LinearOperator& A, VectorConstView v0, uint m,
+    const std::function<void(VectorMutableView)>& project)
+{
+    uint n = v0.size();
+    m = std::min(m, n);
+    std::vector<Vector> V;
+    V.push_back(Vector(v0));
+    if (project)
+    {
+        project(mutableView(V[0]));
+    }
+    Real beta = norm2(V[0]);
+    if (m == 0 || beta == 0.0)
+    {
+        return {};
+    }
+    scale(1.0 / beta, mutableView(V[0]));
+    Matrix H(m + 1, m, 0.0);
+    uint k = 0;  // size of the Hessenberg matrix
+    auto w = Vector(n);
+    for (uint j = 0; j < m; j++)
+    {
+        A(V[j], mutableView(w));
+        if (project)
+        {
+            project(mutableView(w));
+        }
+        Real wnorm = norm2(w);
+        for (uint pass = 0; pass < 2; pass++)
+        {
+            for (uint i = 0; i <= j; i++)
+            {
+                Real h = linear::dot(V[i], w);
+                H(i, j) += h;
+                for (uint l = 0; l < n; l++)
+                {
+                    w(l) -= h * V[i](l);
+                }
+            }
+        }
+        k = j + 1;
+        H(j + 1, j) = norm2(w);
+        if (H(j + 1, j) <= 1e-12 * wnorm)
+        {  // the Krylov space is invariant
+            break;
+        }
+        if (j + 1 < m)
+        {
+            V.push_back(w);
+            scale(1.0 / H(j + 1, j), mutableView(V.back()));
+        }
+    }
+    auto eigs = eigenvaluesHessenberg(blockView(constView(H), 0, 0, k, k));
+    std::sort(eigs.begin(), eigs.end(), [](Complex a, Complex b) {
+        return std::abs(a) > std::abs(b);
+    });
+    return eigs;
+}
+
+// deterministic start vector with no particular structure
+static Vector startVector(uint n)
+{
+    Vector v(n);
+    std::uint32_t state = 12345u;
+    for (uint i = 0; i < n; i++)
+    {
+        state = state * 1664525u + 1013904223u;
+        v(i) = 0.5 + (Real)(state >> 8) / (Real)(1u << 24);
+    }
+    return v;
+}
+
+Complex subdominantEigenvalue(const Spmatrix& P, uint m)
+{
+    assert(P.nrow == P.ncol);
+    auto remove_mean = [](VectorMutableView v) {
+        Real mean = 0.0;
+        for (uint i = 0; i < v.size(); i++)
+        {
+            mean += v(i);
+        }
+        mean /= (Real)v.size();
+        for (uint i = 0; i < v.size(); i++)
+        {
+            v(i) -= mean;
+        }
+    };
+    auto op = [&P](VectorConstView v, VectorMutableView x) { dot(P, v, x); };
+    auto eigs = arnoldiEigenvalues(op, startVector(P.nrow), m, remove_mean);
+    return eigs.empty() ? Complex(0.0) : eigs.front();
+}
+
+Complex subdominantEigenvalue(const LinearOperator& T, uint n, uint m)
+{
+    auto eigs = arnoldiEigenvalues(T, startVector(n), m);
+    if (eigs.empty())
+    {
+        return 0.0;
+    }
+    auto one = std::min_element(
+        eigs.begin(), eigs.end(), [](Complex a, Complex b) {
+            return std::abs(a - 1.0) < std::abs(b - 1.0);
+        });
+    eigs.erase(one);
+    eigs.erase(std::remove_if(eigs.begin(), eigs.end(),
+                              [](Complex a) {
+                                  return std::abs(a + 1.0) < 1e-8;
+                              }),
+               eigs.end());
+    return eigs.empty() ? Complex(0.0) : eigs.front();
+}
+
+// x = T_w v, one SOR sweep of Q x = 0 started at v
+static void sorSweep(const Spmatrix& Q, Real w, VectorConstView v,
+                     VectorMutableView x)
+{
+    assert(Q.format == Spmatrix::RowCompressed);
+    copy(v, x);
+    for (uint i = 0; i < Q.nrow; i++)
+    {
+        Real residual = 0.0;
+        Real a_ii = 0.0;
+        for (uint k = Q.ptr[i]; k < Q.ptr[i + 1]; k++)
+        {
+            if (Q.idx[k] == i)
+            {
+                a_ii = Q.val[k];
+            }
+            else
+            {
+                residual -= Q.val[k] * x(Q.idx[k]);
+            }
+        }
+        x(i) = w * residual / a_ii + (1 - w) * x(i);
+    }
+}
+
+Real sorConvergenceRate(const Spmatrix& Q, Real w, uint m)
+{
+    auto op = [&Q, w](VectorConstView v, VectorMutableView x) {
+        sorSweep(Q, w, v, x);
+    };
+    return std::abs(subdominantEigenvalue(op, Q.nrow, m));
+}
+
+Real sorOptimalRelaxation(const Spmatrix& Q, uint m)
+{
+    assert(Q.format == Spmatrix::RowCompressed);
+    // J = -D^-1 (Q - D)
+    auto jacobi = [&Q](VectorConstView v, VectorMutableView x) {
+        for (uint i = 0; i < Q.nrow; i++)
+        {
+            Real sum = 0.0;
+            Real a_ii = 0.0;
+            for (uint k = Q.ptr[i]; k < Q.ptr[i + 1]; k++)
+            {
+                if (Q.idx[k] == i)
+                {
+                    a_ii = Q.val[k];
+                }
+                else
+                {
+                    sum -= Q.val[k] * v(Q.idx[k]);
+                }
+            }
+            x(i) = sum / a_ii;
+        }
+    };
+    Real mu = std::abs(subdominantEigenvalue(jacobi, Q.nrow, m));
+    if (mu >= 1.0)
+    {
+        return 1.0;
+    }
+    return 2.0 / (1.0 + std::sqrt(1.0 - mu * mu));
+}
+
+uint predictIterations(Real rate, Real tol, Real initial_error)
+{
+    if (rate >= 1.0)
+    {
+        return std::numeric_limits<uint>::max();
+    }
+    if (initial_error <= tol || rate <= 0.0)
+    {
+        return 1;
+    }
+    // the tolerance absorbs the rounding of exact powers of rate
+    Real iter =
+        std::ceil(std::log(tol / initial_error) / std::log(rate) - 1e-9);
+    if (iter >= (Real)std::numeric_limits<uint>::max())
+    {
+        return std::numeric_limits<uint>::max();
+    }
+    return std::max(1u, (uint)iter);
+}
+
 }  // namespace sanity::splinear
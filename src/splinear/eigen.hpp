@@ -1,6 +1,44 @@
 #pragma once
+#include <functional>
+#include <vector>
 #include "linear.hpp"
 #include "matrix.hpp"
 namespace sanity::splinear
 {
-}
+// x = A v
+using LinearOperator = std::function<void(linear::VectorConstView v,
+                                          linear::VectorMutableView x)>;
+
+// Ritz values of A from m steps of Arnoldi started at v0, sorted by
+// decreasing modulus. Gram-Schmidt is repeated once for stability, and the
+// iteration stops early if the Krylov space becomes invariant. project, if
+// given, is applied to every new vector, e.g. to keep the iteration in an
+// invariant subspace.
+std::vector<Complex> arnoldiEigenvalues(
+    const LinearOperator& A, linear::VectorConstView v0, uint m,
+    const std::function<void(linear::VectorMutableView)>& project = nullptr);
+
+// Second largest eigenvalue (by modulus) of a column stochastic matrix,
+// e.g. a uniformized generator. Arnoldi runs on the zero-sum vectors, an
+// invariant subspace that excludes the eigenvalue 1.
+Complex subdominantEigenvalue(const Spmatrix& P, uint m = 30);
+// Same for the iteration matrix T of a stationary method that converges to
+// an eigenvector of T with eigenvalue 1. The Ritz value closest to 1 is
+// dropped, and so is a Ritz value at -1, which the Jacobi matrices of
+// bipartite chains have.
+Complex subdominantEigenvalue(const LinearOperator& T, uint n, uint m = 30);
+
+// Modulus of the subdominant eigenvalue of the SOR iteration matrix of
+// Q x = 0 with relaxation w. The error of SOR shrinks by about this
+// factor per sweep. Q is row compressed with a nonzero diagonal.
+Real sorConvergenceRate(const Spmatrix& Q, Real w, uint m = 30);
+// 2 / (1 + sqrt(1 - mu^2)) with mu the subdominant modulus of the Jacobi
+// matrix (Young's formula). It is optimal for consistently ordered Q, e.g.
+// birth-death chains, and an estimate otherwise.
+Real sorOptimalRelaxation(const Spmatrix& Q, uint m = 30);
+
+// number of iterations for an error to shrink from initial_error to tol at
+// the given rate per iteration. UINT_MAX if rate >= 1.
+uint predictIterations(Real rate, Real tol, Real initial_error = 1.0);
+
+}  // namespace sanity::splinear
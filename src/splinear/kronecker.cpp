@@ -0,0 +1,164 @@
+#include "kronecker.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace sanity::splinear
+{
+using namespace linear;
+
+KronDescriptor::KronDescriptor(std::vector<uint> sizes)
+    : _sizes(std::move(sizes)), _size(1), _terms()
+{
+    for (uint n : _sizes)
+    {
+        _size *= n;
+    }
+}
+
+void KronDescriptor::addLocal(uint c, Spmatrix A)
+{
+    std::vector<KronFactor> factors;
+    factors.push_back({c, std::move(A)});
+    addProduct(1.0, std::move(factors));
+}
+
+void KronDescriptor::addProduct(Real scale, std::vector<KronFactor> factors)
+{
+    std::sort(factors.begin(), factors.end(),
+              [](const KronFactor& f1, const KronFactor& f2) {
+                  return f1.component < f2.component;
+              });
+    for (uint k = 0; k < factors.size(); k++)
+    {
+        const auto& f = factors[k];
+        if (f.component >= componentCount())
+        {
+            throw std::invalid_argument("Kronecker factor of no component.");
+        }
+        if (k > 0 && factors[k - 1].component == f.component)
+        {
+            throw std::invalid_argument(
+                "Two Kronecker factors of the same component.");
+        }
+        if (f.matrix.format != Spmatrix::RowCompressed ||
+            f.matrix.nrow != _sizes[f.component] ||
+            f.matrix.ncol != _sizes[f.component])
+        {
+            throw std::invalid_argument(
+                "Kronecker factor needs to be a row compressed square "
+                "matrix of the component size.");
+        }
+    }
+    _terms.push_back({scale, std::move(factors)});
+}
+
+// out = (I_left x A x I_right) in
+static void modeProduct(const Spmatrix& A, uint nleft, uint nright,
+                        const Real* in, Real* out)
+{
+    const uint n = A.nrow;
+    std::fill(out, out + (size_t)nleft * n * nright, 0.0);
+    for (uint l = 0; l < nleft; l++)
+    {
+        for (uint i = 0; i < n; i++)
+        {
+            Real* dst = out + ((size_t)l * n + i) * nright;
+            for (uint k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+            {
+                const Real a = A.val[k];
+                const Real* src = in + ((size_t)l * n + A.idx[k]) * nright;
+                for (uint r = 0; r < nright; r++)
+                {
+                    dst[r] += a * src[r];
+                }
+            }
+        }
+    }
+}
+
+void dot(const KronDescriptor& D, VectorConstView v, VectorMutableView x)
+{
+    assert(v.size() == D.size());
+    assert(x.size() == D.size());
+    const uint N = D.size();
+    std::vector<uint> nleft(D.componentCount());
+    std::vector<uint> nright(D.componentCount());
+    uint left = 1;
+    for (uint c = 0; c < D.componentCount(); c++)
+    {
+        nleft[c] = left;
+        nright[c] = N / (left * D.componentSize(c));
+        left *= D.componentSize(c);
+    }
+    fill(0.0, x);
+    std::vector<Real> w1(N);
+    std::vector<Real> w2(N);
+    for (const auto& term : D.terms())
+    {
+        for (uint i = 0; i < N; i++)
+        {
+            w1[i] = v(i);
+        }
+        for (const auto& f : term.factors)
+        {
+            modeProduct(f.matrix, nleft[f.component], nright[f.component],
+                        w1.data(), w2.data());
+            std::swap(w1, w2);
+        }
+        for (uint i = 0; i < N; i++)
+        {
+            x(i) += term.scale * w1[i];
+        }
+    }
+}
+
+void addDiagonal(const KronTerm& term, const std::vector<uint>& sizes,
+                 VectorMutableView d)
+{
+    // the diagonal is the Kronecker product of the factor diagonals
+    std::vector<Real> diag(1, term.scale);
+    auto f = term.factors.begin();
+    for (uint c = 0; c < sizes.size(); c++)
+    {
+        std::vector<Real> local(sizes[c], 1.0);
+        if (f != term.factors.end() && f->component == c)
+        {
+            for (uint i = 0; i < sizes[c]; i++)
+            {
+                local[i] = SpmatrixGet(f->matrix, i, i);
+            }
+            ++f;
+        }
+        std::vector<Real> next(diag.size() * sizes[c]);
+        for (uint i = 0; i < diag.size(); i++)
+        {
+            for (uint j = 0; j < sizes[c]; j++)
+            {
+                next[i * sizes[c] + j] = diag[i] * local[j];
+            }
+        }
+        diag = std::move(next);
+    }
+    assert(diag.size() == d.size());
+    for (uint i = 0; i < d.size(); i++)
+    {
+        d(i) += diag[i];
+    }
+}
+
+Vector diagonal(const KronDescriptor& D)
+{
+    std::vector<uint> sizes;
+    for (uint c = 0; c < D.componentCount(); c++)
+    {
+        sizes.push_back(D.componentSize(c));
+    }
+    Vector d(D.size(), 0.0);
+    for (const auto& term : D.terms())
+    {
+        addDiagonal(term, sizes, mutableView(d));
+    }
+    return d;
+}
+
+}  // namespace sanity::splinear
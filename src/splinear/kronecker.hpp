@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include "linear.hpp"
+#include "matrix.hpp"
+#include "type.hpp"
+
+namespace sanity::splinear
+{
+struct KronFactor
+{
+    uint component;
+    Spmatrix matrix;  // row compressed, square
+};
+
+// scale * (A_1 x A_2 x ... x A_N) where A_c is the identity for every
+// component without a factor. factors are sorted by component.
+struct KronTerm
+{
+    Real scale;
+    std::vector<KronFactor> factors;
+};
+
+// Descriptor of a matrix over the product of N component spaces, given as
+// a sum of Kronecker products. State (s_1, ..., s_N) has index
+// ((s_1 * n_2 + s_2) * n_3 + ...) * n_N + s_N, i.e. the last component
+// varies fastest. Only the small component matrices are stored.
+class KronDescriptor
+{
+public:
+    explicit KronDescriptor(std::vector<uint> sizes);
+
+    uint componentCount() const { return _sizes.size(); }
+    uint componentSize(uint c) const { return _sizes[c]; }
+    // product of the component sizes
+    uint size() const { return _size; }
+    const std::vector<KronTerm>& terms() const { return _terms; }
+
+    // adds I x ... x A x ... x I with A at component c
+    void addLocal(uint c, Spmatrix A);
+    // adds scale * (A_1 x ... x A_N). throws std::invalid_argument if a
+    // factor does not match its component, or a component is repeated.
+    void addProduct(Real scale, std::vector<KronFactor> factors);
+
+private:
+    std::vector<uint> _sizes;
+    uint _size;
+    std::vector<KronTerm> _terms;
+};
+
+// x = D v with the shuffle algorithm. Every term multiplies its factors one
+// component at a time, and identity factors cost nothing.
+void dot(const KronDescriptor& D, linear::VectorConstView v,
+         linear::VectorMutableView x);
+
+// d += diag(term) over components of the given sizes
+void addDiagonal(const KronTerm& term, const std::vector<uint>& sizes,
+                 linear::VectorMutableView d);
+linear::Vector diagonal(const KronDescriptor& D);
+
+}  // namespace sanity::splinear
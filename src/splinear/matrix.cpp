@@ -1,131 +1,147 @@
 #include "matrix.hpp"
 #include <algorithm>
+#include "parallel.hpp"
 
 namespace sanity::splinear
 {
-static bool compTripleRow(const SpmatrixTriple::Triple& e1,
-                          const SpmatrixTriple::Triple& e2)
+using parallel::parallelFor;
+using parallel::threadCount;
+
+using Triple = SpmatrixTriple::Triple;
+
+// Stable counting sort of src into dst by key(triple) in [0, nkey). Every
+// thread counts the keys of its own block of src, so that it can also
+// scatter its block without synchronization. key_start receives the
+// offset of each key in dst.
+template <typename KeyFn>
+static void countingSort(const std::vector<Triple>& src,
+                         std::vector<Triple>& dst, uint nkey, KeyFn key,
+                         uint nthread, std::vector<uint>& key_start)
 {
-    if (e1.row < e2.row)
-    {
-        return true;
-    }
-    else if (e1.row > e2.row)
-    {
-        return false;
-    }
-    else if (e1.col < e2.col)
-    {
-        return true;
-    }
-    else
+    uint n = (uint)src.size();
+    std::vector<std::vector<uint>> counts(nthread);
+    parallelFor(0, n, nthread, [&](uint tid, uint begin, uint end) {
+        auto& count = counts[tid];
+        count.assign(nkey, 0);
+        for (uint i = begin; i < end; i++)
+        {
+            count[key(src[i])] += 1;
+        }
+    });
+    // counts[tid][k] becomes the offset of the first triple of thread tid
+    // with key k
+    key_start.resize(nkey + 1);
+    uint offset = 0;
+    for (uint k = 0; k < nkey; k++)
     {
-        return false;
+        key_start[k] = offset;
+        for (uint tid = 0; tid < nthread; tid++)
+        {
+            uint c = counts[tid][k];
+            counts[tid][k] = offset;
+            offset += c;
+        }
     }
+    key_start[nkey] = offset;
+    dst.resize(n);
+    parallelFor(0, n, nthread, [&](uint tid, uint begin, uint end) {
+        auto& next = counts[tid];
+        for (uint i = begin; i < end; i++)
+        {
+            dst[next[key(src[i])]++] = src[i];
+        }
+    });
 }
 
-static bool compTripleCol(const SpmatrixTriple::Triple& e1,
-                          const SpmatrixTriple::Triple& e2)
+// returns the offset of each major index in the sorted triples
+static std::vector<uint> sortTriplesByMajor(SpmatrixTriple& spmat,
+                                            bool rowFirst, uint nthread)
 {
-    if (e1.col < e2.col)
-    {
-        return true;
-    }
-    else if (e1.col > e2.col)
-    {
-        return false;
-    }
-    else if (e1.row < e2.row)
+    nthread = threadCount(nthread);
+    auto row = [](const Triple& t) { return t.row; };
+    auto col = [](const Triple& t) { return t.col; };
+    std::vector<Triple> tmp;
+    std::vector<uint> major_start;
+    // least significant key first
+    if (rowFirst)
     {
-        return true;
+        countingSort(spmat.triples, tmp, spmat.ncol, col, nthread,
+                     major_start);
+        countingSort(tmp, spmat.triples, spmat.nrow, row, nthread,
+                     major_start);
     }
     else
     {
-        return false;
+        countingSort(spmat.triples, tmp, spmat.nrow, row, nthread,
+                     major_start);
+        countingSort(tmp, spmat.triples, spmat.ncol, col, nthread,
+                     major_start);
     }
+    return major_start;
 }
 
-void sortTriples(SpmatrixTriple& spmat, bool rowFirst)
+void sortTriples(SpmatrixTriple& spmat, bool rowFirst, uint nthread)
 {
-    if (rowFirst)
-    {
-        std::sort(spmat.triples.begin(), spmat.triples.end(), compTripleRow);
-    }
-    else
-    {
-        std::sort(spmat.triples.begin(), spmat.triples.end(), compTripleCol);
-    }
+    sortTriplesByMajor(spmat, rowFirst, nthread);
 }
 
 Spmatrix triple2compressed(SpmatrixTriple& trimat,
-                           Spmatrix::Format target_format)
+                           Spmatrix::Format target_format, uint nthread)
 {
-    sortTriples(trimat, target_format == Spmatrix::RowCompressed);
+    nthread = threadCount(nthread);
+    bool row_first = target_format == Spmatrix::RowCompressed;
+    auto major_start = sortTriplesByMajor(trimat, row_first, nthread);
+    const auto& triples = trimat.triples;
+    auto minor = [&](const Triple& t) { return row_first ? t.col : t.row; };
+    uint nmajor = row_first ? trimat.nrow : trimat.ncol;
     Spmatrix csmat(trimat.nrow, trimat.ncol, target_format);
-    if (target_format == Spmatrix::RowCompressed)
-    {
-        uint m = trimat.nrow;
-        csmat.ptr.reserve(trimat.nrow + 1);
-        csmat.ptr.push_back(0);
-        csmat.idx.reserve(trimat.triples.size());
-        csmat.val.reserve(trimat.triples.size());
-        auto itor = trimat.triples.begin();
-        for (uint i = 0; i < m; i++)
+
+    // duplicates are adjacent now. first count the merged nonzeros of
+    // every major index, then write them.
+    auto merge = [&](uint i, auto&& emit) {
+        uint k = major_start[i];
+        while (k < major_start[i + 1])
         {
-            uint counter = 0;
-            while (itor != trimat.triples.end() && itor->row == i)
+            uint idx = minor(triples[k]);
+            Real val = triples[k].val;
+            k += 1;
+            while (k < major_start[i + 1] && minor(triples[k]) == idx)
             {
-                uint idx = itor->col;
-                Real val = itor->val;
-                itor += 1;
-                while (itor != trimat.triples.end() && itor->row == i &&
-                       itor->col == idx)
-                {
-                    val += itor->val;
-                    itor += 1;
-                }
-                if (val != 0.0)
-                {
-                    csmat.idx.push_back(idx);
-                    csmat.val.push_back(val);
-                    counter += 1;
-                }
+                val += triples[k].val;
+                k += 1;
             }
-            csmat.ptr.push_back(counter + csmat.ptr[i]);
-        }
-    }
-    else
-    {
-        uint n = trimat.ncol;
-        csmat.ptr.reserve(n + 1);
-        csmat.ptr.push_back(0);
-        csmat.idx.reserve(trimat.triples.size());
-        csmat.val.reserve(trimat.triples.size());
-        auto itor = trimat.triples.begin();
-        for (uint i = 0; i < n; i++)
-        {
-            uint counter = 0;
-            while (itor != trimat.triples.end() && itor->col == i)
+            if (val != 0.0)
             {
-                uint idx = itor->row;
-                Real val = itor->val;
-                itor += 1;
-                while (itor != trimat.triples.end() && itor->col == i &&
-                       itor->row == idx)
-                {
-                    val += itor->val;
-                    itor += 1;
-                }
-                if (val != 0.0)
-                {
-                    csmat.idx.push_back(idx);
-                    csmat.val.push_back(val);
-                    counter += 1;
-                }
+                emit(idx, val);
             }
-            csmat.ptr.push_back(counter + csmat.ptr[i]);
         }
+    };
+    csmat.ptr.assign(nmajor + 1, 0);
+    parallelFor(0, nmajor, nthread, [&](uint, uint begin, uint end) {
+        for (uint i = begin; i < end; i++)
+        {
+            uint count = 0;
+            merge(i, [&](uint, Real) { count += 1; });
+            csmat.ptr[i + 1] = count;
+        }
+    });
+    for (uint i = 0; i < nmajor; i++)
+    {
+        csmat.ptr[i + 1] += csmat.ptr[i];
     }
+    csmat.idx.resize(csmat.ptr[nmajor]);
+    csmat.val.resize(csmat.ptr[nmajor]);
+    parallelFor(0, nmajor, nthread, [&](uint, uint begin, uint end) {
+        for (uint i = begin; i < end; i++)
+        {
+            uint pos = csmat.ptr[i];
+            merge(i, [&](uint idx, Real val) {
+                csmat.idx[pos] = idx;
+                csmat.val[pos] = val;
+                pos += 1;
+            });
+        }
+    });
     return csmat;
 }
 
@@ -38,9 +38,14 @@ struct SpmatrixTriple
     SpmatrixTriple(uint nrow, uint ncol) : nrow(nrow), ncol(ncol) {}
 };
 
-void sortTriples(SpmatrixTriple& spmat, bool rowFirst);
+// Sorts by (row, col) or by (col, row) with two stable counting sorts, in
+// O(nnz + nrow + ncol). nthread == 0 uses every hardware thread.
+void sortTriples(SpmatrixTriple& spmat, bool rowFirst, uint nthread = 1);
+// Duplicated entries are summed, and zero sums are dropped. trimat is left
+// sorted.
 Spmatrix triple2compressed(SpmatrixTriple& trimat,
-                           Spmatrix::Format target_format);
+                           Spmatrix::Format target_format,
+                           uint nthread = 1);
 
 class SpmatrixCreator
 {
@@ -53,9 +58,9 @@ public:
     {
         _trmat.triples.push_back({row, col, val});
     }
-    Spmatrix create(Spmatrix::Format target_format)
+    Spmatrix create(Spmatrix::Format target_format, uint nthread = 1)
     {
-        return triple2compressed(_trmat, target_format);
+        return triple2compressed(_trmat, target_format, nthread);
     }
 };
 
@@ -123,7 +128,7 @@ inline SpmatrixRowConstIterator initRowIter(const Spmatrix& spmat, uint row)
 
 inline SpmatrixColConstIterator initColIter(const Spmatrix& spmat, uint col)
 {
-    assert(spmat.format == Spmatrix::RowCompressed);
+    assert(spmat.format == Spmatrix::ColCompressed);
     return SpmatrixColConstIterator(&spmat.idx[spmat.ptr[col]],
                                     &spmat.idx[spmat.ptr[col + 1]],
                                     &spmat.val[spmat.ptr[col]]);
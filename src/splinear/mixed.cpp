@@ -0,0 +1,134 @@
+#include "mixed.hpp"
+#include <cassert>
+#include <cmath>
+#include "oper.hpp"
+
+namespace sanity::splinear
+{
+using namespace linear;
+
+SpmatrixFloat spmatrix2float(const Spmatrix& A)
+{
+    SpmatrixFloat fmat(A.nrow, A.ncol, A.format);
+    fmat.ptr = A.ptr;
+    fmat.idx = A.idx;
+    fmat.val.reserve(A.val.size());
+    for (Real v : A.val)
+    {
+        fmat.val.push_back((float)v);
+    }
+    return fmat;
+}
+
+void dot(const SpmatrixFloat& A, VectorConstView v, VectorMutableView x)
+{
+    assert(A.ncol == v.size());
+    assert(A.nrow == x.size());
+    if (A.format == Spmatrix::RowCompressed)
+    {
+        for (uint row = 0; row < A.nrow; row++)
+        {
+            Real sum = 0.0;
+            for (uint k = A.ptr[row]; k < A.ptr[row + 1]; k++)
+            {
+                sum += (Real)A.val[k] * v(A.idx[k]);
+            }
+            x(row) = sum;
+        }
+    }
+    else
+    {
+        fill(0.0, x);
+        for (uint col = 0; col < A.ncol; col++)
+        {
+            for (uint k = A.ptr[col]; k < A.ptr[col + 1]; k++)
+            {
+                x(A.idx[k]) += (Real)A.val[k] * v(col);
+            }
+        }
+    }
+}
+
+Real sorSweep(const SpmatrixFloat& A, VectorMutableView x, VectorConstView b,
+              Real w)
+{
+    Real max_change = 0.0;
+    for (uint i = 0; i < A.nrow; i++)
+    {
+        Real residual = b(i);
+        Real a_ii = 0;
+        for (uint k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+        {
+            uint col = A.idx[k];
+            if (col == i)  // diag
+            {
+                a_ii = (Real)A.val[k];
+            }
+            else
+            {  // non diag
+                residual -= (Real)A.val[k] * x(col);
+            }
+        }
+        Real next = w * residual / a_ii + (1 - w) * x(i);
+        Real change = std::abs(next - x(i));
+        if (max_change < change || std::isnan(change))
+        {
+            max_change = change;
+        }
+        x(i) = next;
+    }
+    return max_change;
+}
+
+IterationResult solveSorMixed(const Spmatrix& A, VectorMutableView x,
+                              VectorConstView b, Real w, Real tol,
+                              uint max_iter, uint refine_interval)
+{
+    assert(A.nrow == A.ncol);
+    assert(A.nrow == (uint)x.size());
+    assert(A.nrow == (uint)b.size());
+    assert(x.size() > 0);
+    assert(A.format == Spmatrix::RowCompressed);
+    assert(refine_interval > 0);
+    auto Af = spmatrix2float(A);
+    auto residual = Vector(x.size());
+    auto correction = Vector(x.size());
+    uint iter = 0;
+    Real error = NAN;
+    while (iter < max_iter)
+    {
+        // residual = b - Ax in double precision
+        dot(A, x, mutableView(residual));
+        for (uint i = 0; i < x.size(); i++)
+        {
+            residual(i) = b(i) - residual(i);
+        }
+        // A * correction = residual in single precision
+        fill(0.0, mutableView(correction));
+        for (uint k = 0; k < refine_interval && iter < max_iter; k++)
+        {
+            iter++;
+            if (sorSweep(Af, mutableView(correction), residual, w) < tol)
+            {
+                break;
+            }
+        }
+        error = 0.0;
+        for (uint i = 0; i < x.size(); i++)
+        {
+            x(i) += correction(i);
+            Real c = std::abs(correction(i));
+            if (error < c || std::isnan(c))
+            {
+                error = c;
+            }
+        }
+        if (error < tol)
+        {
+            break;
+        }
+    }
+    return {.error = error, .nIter = iter};
+}
+
+}  // namespace sanity::splinear
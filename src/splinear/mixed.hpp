@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include "linear.hpp"
+#include "matrix.hpp"
+#include "type.hpp"
+
+namespace sanity::splinear
+{
+// Same layout as Spmatrix, but the values are stored in single precision.
+// Kernels still accumulate in double precision.
+struct SpmatrixFloat
+{
+    Spmatrix::Format format;
+    std::vector<uint> ptr;
+    std::vector<uint> idx;
+    std::vector<float> val;
+    uint nrow;
+    uint ncol;
+    SpmatrixFloat(uint nrow, uint ncol, Spmatrix::Format format)
+        : format(format), nrow(nrow), ncol(ncol)
+    {
+    }
+};
+
+SpmatrixFloat spmatrix2float(const Spmatrix& A);
+
+// x = Av
+void dot(const SpmatrixFloat& A, linear::VectorConstView v,
+         linear::VectorMutableView x);
+
+// one SOR sweep for Ax = b, returns the max change of x. A needs to be row
+// compressed.
+Real sorSweep(const SpmatrixFloat& A, linear::VectorMutableView x,
+              linear::VectorConstView b, Real w);
+
+// Mixed precision SOR with iterative refinement. The residual b - Ax is
+// computed with the double precision A every refine_interval sweeps, and
+// the correction is solved by SOR sweeps over a single precision copy of A.
+// The returned error is the size of the last correction.
+IterationResult solveSorMixed(const Spmatrix& A, linear::VectorMutableView x,
+                              linear::VectorConstView b, Real w, Real tol,
+                              uint max_iter, uint refine_interval = 10);
+
+}  // namespace sanity::splinear
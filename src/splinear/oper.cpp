@@ -2,8 +2,9 @@
 #include <cassert>
 namespace sanity::splinear
 {
-void dot(const Spmatrix& A, linear::VectorConstView v,
-         linear::VectorMutableView x)
+template <typename Matrix>
+static void dotT(const Matrix& A, linear::VectorConstView v,
+                 linear::VectorMutableView x)
 {
     assert(A.ncol == v.size());
     assert(A.nrow == x.size());
@@ -35,8 +36,9 @@ void dot(const Spmatrix& A, linear::VectorConstView v,
     }
 }
 
-void dotpx(const Spmatrix& A, linear::VectorConstView v,
-           linear::VectorMutableView x)
+template <typename Matrix>
+static void dotpxT(const Matrix& A, linear::VectorConstView v,
+                   linear::VectorMutableView x)
 {
     assert(A.ncol == v.size());
     assert(A.nrow == x.size());
@@ -65,4 +67,52 @@ void dotpx(const Spmatrix& A, linear::VectorConstView v,
         }
     }
 }
+
+void dot(const Spmatrix& A, linear::VectorConstView v,
+         linear::VectorMutableView x)
+{
+    dotT(A, v, x);
+}
+void dot(const SpmatrixCompact& A, linear::VectorConstView v,
+         linear::VectorMutableView x)
+{
+    if (A.format != Spmatrix::RowCompressed)
+    {
+        dotT(A, v, x);
+        return;
+    }
+    assert(A.ncol == v.size());
+    assert(A.nrow == x.size());
+    for (uint row = 0; row < A.nrow; row++)
+    {
+        Real sum = 0.0;
+        uint col = row;
+        for (uint k = A.ptr[row]; k < A.ptr[row + 1]; k++)
+        {
+            if (A.delta[k] != SpmatrixCompact::farIndex)
+            {
+                col = (uint)((int)col + A.delta[k]);
+                sum += A.val[k] * v(col);
+            }
+            else
+            {
+                col = compactFarIndex(&A.delta[k]);
+                sum += A.val[k] * v(col);
+                k += 2;
+            }
+        }
+        x(row) = sum;
+    }
+}
+
+void dotpx(const Spmatrix& A, linear::VectorConstView v,
+           linear::VectorMutableView x)
+{
+    dotpxT(A, v, x);
+}
+void dotpx(const SpmatrixCompact& A, linear::VectorConstView v,
+           linear::VectorMutableView x)
+{
+    dotpxT(A, v, x);
+}
 }  // namespace sanity::splinear
@@ -1,4 +1,5 @@
 #pragma once
+#include "compact.hpp"
 #include "linear.hpp"
 #include "matrix.hpp"
 namespace sanity::splinear
@@ -14,5 +15,9 @@ void dot(const Spmatrix& A, linear::VectorConstView v,
          linear::VectorMutableView x);
 void dotpx(const Spmatrix& A, linear::VectorConstView v,
            linear::VectorMutableView x);
+void dot(const SpmatrixCompact& A, linear::VectorConstView v,
+         linear::VectorMutableView x);
+void dotpx(const SpmatrixCompact& A, linear::VectorConstView v,
+           linear::VectorMutableView x);
 
 }  // namespace sanity::splinear
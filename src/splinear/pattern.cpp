@@ -0,0 +1,112 @@
+#include "pattern.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace sanity::splinear
+{
+SpmatrixPattern SpmatrixPatternCreator::create(
+    Spmatrix::Format target_format, const std::vector<Real>& params) const
+{
+    assert(params.size() == _nkey);
+    bool row_first = target_format == Spmatrix::RowCompressed;
+    auto major = [&](const Entry& e) { return row_first ? e.row : e.col; };
+    auto minor = [&](const Entry& e) { return row_first ? e.col : e.row; };
+    std::vector<uint> order(_entries.size());
+    for (uint i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](uint i1, uint i2) {
+        const auto& e1 = _entries[i1];
+        const auto& e2 = _entries[i2];
+        if (major(e1) != major(e2))
+        {
+            return major(e1) < major(e2);
+        }
+        return minor(e1) < minor(e2);
+    });
+
+    SpmatrixPattern pat{Spmatrix(_nrow, _ncol, target_format), {}};
+    auto& mat = pat.matrix;
+    auto& map = pat.valueMap;
+    uint n = row_first ? _nrow : _ncol;
+    mat.ptr.assign(n + 1, 0);
+    // position of every entry in val
+    std::vector<uint> entry_pos(_entries.size());
+    for (uint k = 0; k < order.size(); k++)
+    {
+        const auto& e = _entries[order[k]];
+        if (k == 0 || major(e) != major(_entries[order[k - 1]]) ||
+            minor(e) != minor(_entries[order[k - 1]]))
+        {
+            mat.idx.push_back(minor(e));
+            map.constVal.push_back(0.0);
+            mat.ptr[major(e) + 1] += 1;
+        }
+        uint pos = mat.idx.size() - 1;
+        entry_pos[order[k]] = pos;
+        if (e.key == _nkey)
+        {
+            map.constVal[pos] += e.coef;
+        }
+    }
+    for (uint i = 0; i < n; i++)
+    {
+        mat.ptr[i + 1] += mat.ptr[i];
+    }
+
+    // slots grouped by key, only for the keys that are used
+    std::vector<uint> slot_entry;
+    for (uint i = 0; i < _entries.size(); i++)
+    {
+        if (_entries[i].key < _nkey)
+        {
+            slot_entry.push_back(i);
+        }
+    }
+    std::stable_sort(slot_entry.begin(), slot_entry.end(),
+                     [&](uint i1, uint i2) {
+                         return _entries[i1].key < _entries[i2].key;
+                     });
+    map.paramCount = _nkey;
+    map.pos.reserve(slot_entry.size());
+    map.coef.reserve(slot_entry.size());
+    for (uint s = 0; s < slot_entry.size(); s++)
+    {
+        const auto& e = _entries[slot_entry[s]];
+        if (map.keys.empty() || map.keys.back() != e.key)
+        {
+            map.keys.push_back(e.key);
+            map.keyPtr.push_back(s);
+        }
+        map.pos.push_back(entry_pos[slot_entry[s]]);
+        map.coef.push_back(e.coef);
+    }
+    map.keyPtr.push_back((uint)slot_entry.size());
+    mat.val.resize(mat.idx.size());
+    updateValues(mat, map, params);
+    return pat;
+}
+
+void updateValues(Spmatrix& A, const SpmatrixValueMap& map,
+                  const std::vector<Real>& params)
+{
+    assert(params.size() == map.paramCount);
+    assert(A.val.size() == map.constVal.size());
+    std::copy(map.constVal.begin(), map.constVal.end(), A.val.begin());
+    for (uint k = 0; k < map.keys.size(); k++)
+    {
+        Real p = params[map.keys[k]];
+        for (uint s = map.keyPtr[k]; s < map.keyPtr[k + 1]; s++)
+        {
+            A.val[map.pos[s]] += map.coef[s] * p;
+        }
+    }
+}
+
+void updateValues(SpmatrixPattern& pattern, const std::vector<Real>& params)
+{
+    updateValues(pattern.matrix, pattern.valueMap, params);
+}
+
+}  // namespace sanity::splinear
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include "matrix.hpp"
+#include "type.hpp"
+
+namespace sanity::splinear
+{
+// Maps a parameter vector (e.g. edge rates) to the values of a matrix whose
+// sparsity pattern does not depend on the parameters:
+// val[k] = constVal[k] + sum of coef[s] * params[key] over the slots s of
+// every key contributing to nonzero k.
+// Only the keys that contribute to the matrix are stored, so the size of
+// the map and the cost of a refresh do not depend on the size of params.
+struct SpmatrixValueMap
+{
+    std::vector<Real> constVal;  // one per nonzero
+    uint paramCount;             // expected size of params
+    std::vector<uint> keys;      // the used keys, ascending
+    // the slots of keys[i] are [keyPtr[i], keyPtr[i + 1])
+    std::vector<uint> keyPtr;
+    std::vector<uint> pos;  // position in val of each slot
+    std::vector<Real> coef;
+};
+
+struct SpmatrixPattern
+{
+    Spmatrix matrix;
+    SpmatrixValueMap valueMap;
+};
+
+// Like SpmatrixCreator, but the entries are linear in a parameter vector.
+// The created matrix keeps every structural nonzero, even when its current
+// value is zero.
+class SpmatrixPatternCreator
+{
+    struct Entry
+    {
+        uint row;
+        uint col;
+        uint key;  // keyCount for constants
+        Real coef;
+    };
+    std::vector<Entry> _entries;
+    uint _nrow;
+    uint _ncol;
+    uint _nkey;
+
+public:
+    SpmatrixPatternCreator(uint nrow, uint ncol, uint nkey)
+        : _nrow(nrow), _ncol(ncol), _nkey(nkey)
+    {
+    }
+    void reserve(uint nEntry) { _entries.reserve(nEntry); }
+    // (row, col) += coef * params[key]
+    void addEntry(uint row, uint col, uint key, Real coef = 1.0)
+    {
+        assert(key < _nkey);
+        _entries.push_back({row, col, key, coef});
+    }
+    // (row, col) += val
+    void addConstant(uint row, uint col, Real val)
+    {
+        _entries.push_back({row, col, _nkey, val});
+    }
+    // the values of the matrix are computed from params
+    SpmatrixPattern create(Spmatrix::Format target_format,
+                           const std::vector<Real>& params) const;
+};
+
+// refreshes the values of A in O(nnz + slots) without any allocation
+void updateValues(Spmatrix& A, const SpmatrixValueMap& map,
+                  const std::vector<Real>& params);
+void updateValues(SpmatrixPattern& pattern, const std::vector<Real>& params);
+
+}  // namespace sanity::splinear
@@ -0,0 +1,262 @@
+#include "sell.hpp"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace sanity::splinear
+{
+using namespace linear;
+
+SellMatrix spmatrix2sell(const Spmatrix& A, uint chunk_size, uint sigma)
+{
+    assert(A.format == Spmatrix::RowCompressed);
+    assert(chunk_size > 0);
+    assert(A.ncol <= (uint)std::numeric_limits<int>::max());
+    if (sigma < chunk_size)
+    {
+        sigma = chunk_size;
+    }
+    sigma = (sigma + chunk_size - 1) / chunk_size * chunk_size;
+    SellMatrix sell(A.nrow, A.ncol, chunk_size, sigma);
+
+    // sort rows by length (longest first) within each sigma window
+    sell.rowPerm.resize(A.nrow);
+    for (uint i = 0; i < A.nrow; i++)
+    {
+        sell.rowPerm[i] = i;
+    }
+    auto row_len = [&](uint row) { return A.ptr[row + 1] - A.ptr[row]; };
+    for (uint start = 0; start < A.nrow; start += sigma)
+    {
+        uint end = std::min(start + sigma, A.nrow);
+        std::stable_sort(sell.rowPerm.begin() + start,
+                         sell.rowPerm.begin() + end, [&](uint r1, uint r2) {
+                             return row_len(r1) > row_len(r2);
+                         });
+    }
+
+    uint nchunk = (A.nrow + chunk_size - 1) / chunk_size;
+    sell.chunkPtr.reserve(nchunk + 1);
+    sell.chunkLen.reserve(nchunk);
+    sell.chunkPtr.push_back(0);
+    for (uint c = 0; c < nchunk; c++)
+    {
+        uint len = 0;
+        for (uint lane = 0; lane < chunk_size; lane++)
+        {
+            uint srow = c * chunk_size + lane;
+            if (srow < A.nrow)
+            {
+                len = std::max(len, row_len(sell.rowPerm[srow]));
+            }
+        }
+        sell.chunkLen.push_back(len);
+        sell.chunkPtr.push_back(sell.chunkPtr.back() + len * chunk_size);
+    }
+
+    sell.idx.assign(sell.chunkPtr.back(), 0);
+    sell.val.assign(sell.chunkPtr.back(), 0.0);
+    for (uint c = 0; c < nchunk; c++)
+    {
+        for (uint lane = 0; lane < chunk_size; lane++)
+        {
+            uint srow = c * chunk_size + lane;
+            if (srow >= A.nrow)
+            {
+                break;
+            }
+            uint row = sell.rowPerm[srow];
+            uint pad_col = 0;
+            for (uint j = 0; j < sell.chunkLen[c]; j++)
+            {
+                uint pos = sell.chunkPtr[c] + j * chunk_size + lane;
+                if (j < row_len(row))
+                {
+                    sell.idx[pos] = A.idx[A.ptr[row] + j];
+                    sell.val[pos] = A.val[A.ptr[row] + j];
+                    pad_col = sell.idx[pos];
+                }
+                else
+                {  // repeat the last column so that padding stays in cache
+                    sell.idx[pos] = pad_col;
+                }
+            }
+        }
+    }
+    return sell;
+}
+
+static void sellDotScalar(const SellMatrix& A, VectorConstView v,
+                          VectorMutableView x)
+{
+    const uint C = A.chunkSize;
+    std::vector<Real> acc(C);
+    for (uint c = 0; c < A.chunkCount(); c++)
+    {
+        std::fill(acc.begin(), acc.end(), 0.0);
+        const uint* idx = A.idx.data() + A.chunkPtr[c];
+        const Real* val = A.val.data() + A.chunkPtr[c];
+        for (uint j = 0; j < A.chunkLen[c]; j++)
+        {
+            for (uint lane = 0; lane < C; lane++)
+            {
+                acc[lane] += val[j * C + lane] * v(idx[j * C + lane]);
+            }
+        }
+        uint nlane = std::min(C, A.nrow - c * C);
+        for (uint lane = 0; lane < nlane; lane++)
+        {
+            x(A.rowPerm[c * C + lane]) = acc[lane];
+        }
+    }
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2,fma"))) static void sellDotAvx2(
+    const SellMatrix& A, const Real* v, VectorMutableView x)
+{
+    const uint C = A.chunkSize;
+    alignas(32) Real acc[4];
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for (uint c = 0; c < A.chunkCount(); c++)
+    {
+        const uint* idx = A.idx.data() + A.chunkPtr[c];
+        const Real* val = A.val.data() + A.chunkPtr[c];
+        uint nlane = std::min(C, A.nrow - c * C);
+        for (uint g = 0; g < C; g += 4)
+        {
+            __m256d sum = _mm256_setzero_pd();
+            for (uint j = 0; j < A.chunkLen[c]; j++)
+            {
+                uint off = j * C + g;
+                __m128i vidx = _mm_loadu_si128((const __m128i*)(idx + off));
+                __m256d vval = _mm256_loadu_pd(val + off);
+                __m256d vx = _mm256_mask_i32gather_pd(_mm256_setzero_pd(),
+                                                      v, vidx, all, 8);
+                sum = _mm256_fmadd_pd(vval, vx, sum);
+            }
+            _mm256_store_pd(acc, sum);
+            for (uint lane = g; lane < std::min(g + 4, nlane); lane++)
+            {
+                x(A.rowPerm[c * C + lane]) = acc[lane - g];
+            }
+        }
+    }
+}
+
+// Without optimisation gcc expands the gather intrinsic to a macro that
+// narrows its all-ones __mmask8 to char, which -Wsign-conversion rejects.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+__attribute__((target("avx512f"))) static void sellDotAvx512(
+    const SellMatrix& A, const Real* v, VectorMutableView x)
+{
+    const uint C = A.chunkSize;
+    alignas(64) Real acc[8];
+    const __mmask8 all = 0xff;
+    for (uint c = 0; c < A.chunkCount(); c++)
+    {
+        const uint* idx = A.idx.data() + A.chunkPtr[c];
+        const Real* val = A.val.data() + A.chunkPtr[c];
+        uint nlane = std::min(C, A.nrow - c * C);
+        for (uint g = 0; g < C; g += 8)
+        {
+            __m512d sum = _mm512_setzero_pd();
+            for (uint j = 0; j < A.chunkLen[c]; j++)
+            {
+                uint off = j * C + g;
+                __m256i vidx =
+                    _mm256_loadu_si256((const __m256i*)(idx + off));
+                __m512d vval = _mm512_loadu_pd(val + off);
+                __m512d vx = _mm512_mask_i32gather_pd(
+                    _mm512_setzero_pd(), all, vidx, v, 8);
+                sum = _mm512_fmadd_pd(vval, vx, sum);
+            }
+            _mm512_store_pd(acc, sum);
+            for (uint lane = g; lane < std::min(g + 8, nlane); lane++)
+            {
+                x(A.rowPerm[c * C + lane]) = acc[lane - g];
+            }
+        }
+    }
+}
+#pragma GCC diagnostic pop
+#endif
+
+static SellKernel cpuKernel()
+{
+#if defined(__x86_64__)
+    static const SellKernel kernel = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+        {
+            return SellKernel::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return SellKernel::Avx2;
+        }
+        return SellKernel::Scalar;
+    }();
+    return kernel;
+#else
+    return SellKernel::Scalar;
+#endif
+}
+
+static SellKernel supportedKernel(const SellMatrix& A, SellKernel wanted)
+{
+    SellKernel cpu = cpuKernel();
+    if (wanted == SellKernel::Avx512 &&
+        (cpu != SellKernel::Avx512 || A.chunkSize % 8 != 0))
+    {
+        wanted = SellKernel::Avx2;
+    }
+    if (wanted == SellKernel::Avx2 &&
+        (cpu == SellKernel::Scalar || A.chunkSize % 4 != 0))
+    {
+        wanted = SellKernel::Scalar;
+    }
+    return wanted;
+}
+
+SellKernel sellKernel(const SellMatrix& A)
+{
+    return supportedKernel(A, SellKernel::Avx512);
+}
+
+void dot(const SellMatrix& A, VectorConstView v, VectorMutableView x)
+{
+    dot(A, v, x, SellKernel::Avx512);
+}
+
+void dot(const SellMatrix& A, VectorConstView v, VectorMutableView x,
+         SellKernel kernel)
+{
+    assert(A.ncol == v.size());
+    assert(A.nrow == x.size());
+    kernel = supportedKernel(A, kernel);
+    if (v.inc() != 1 || A.idx.empty())
+    {  // gathers need a contiguous source vector
+        kernel = SellKernel::Scalar;
+    }
+    switch (kernel)
+    {
+#if defined(__x86_64__)
+        case SellKernel::Avx512:
+            sellDotAvx512(A, &v(0), x);
+            break;
+        case SellKernel::Avx2:
+            sellDotAvx2(A, &v(0), x);
+            break;
+#endif
+        default:
+            sellDotScalar(A, v, x);
+            break;
+    }
+}
+
+}  // namespace sanity::splinear
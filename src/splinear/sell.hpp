@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include "linear.hpp"
+#include "matrix.hpp"
+#include "type.hpp"
+
+namespace sanity::splinear
+{
+// Sliced ELLPACK (SELL-C-sigma) storage. Rows are sorted by their number of
+// nonzeros inside windows of sigma rows and then grouped into chunks of C
+// rows. Every chunk is padded to its longest row and stored column-major,
+// so that the j-th nonzeros of C consecutive rows are adjacent in memory and
+// can be processed by one vector instruction.
+struct SellMatrix
+{
+    uint nrow;
+    uint ncol;
+    uint chunkSize;
+    uint sigma;
+    std::vector<uint> chunkPtr;  // offset of each chunk in idx and val
+    std::vector<uint> chunkLen;  // padded row length of each chunk
+    std::vector<uint> rowPerm;   // sell row -> matrix row
+    std::vector<uint> idx;       // padding entries have val 0
+    std::vector<Real> val;
+    SellMatrix(uint nrow, uint ncol, uint chunk_size, uint sigma)
+        : nrow(nrow), ncol(ncol), chunkSize(chunk_size), sigma(sigma)
+    {
+    }
+    uint chunkCount() const { return chunkLen.size(); }
+};
+
+// A needs to be row compressed. sigma is rounded up to a multiple of
+// chunk_size; sigma == chunk_size keeps the original row order within
+// chunks.
+SellMatrix spmatrix2sell(const Spmatrix& A, uint chunk_size = 8,
+                         uint sigma = 256);
+
+enum class SellKernel
+{
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+// the widest kernel supported by both the running cpu and the chunk size
+SellKernel sellKernel(const SellMatrix& A);
+
+// x = Av
+void dot(const SellMatrix& A, linear::VectorConstView v,
+         linear::VectorMutableView x);
+// kernel is lowered to the best supported one if necessary
+void dot(const SellMatrix& A, linear::VectorConstView v,
+         linear::VectorMutableView x, SellKernel kernel);
+
+}  // namespace sanity::splinear
@@ -4,9 +4,10 @@
 namespace sanity::splinear
 {
 using namespace linear;
-IterationResult solveSor(const Spmatrix& A, linear::VectorMutableView x,
-                         linear::VectorConstView b, Real w, Real tol,
-                         uint max_iter)
+template <typename Matrix>
+static IterationResult solveSorT(const Matrix& A, linear::VectorMutableView x,
+                                 linear::VectorConstView b, Real w, Real tol,
+                                 uint max_iter)
 {
     assert(A.nrow == A.ncol);
     assert(A.nrow == (uint)x.size());
@@ -56,4 +57,19 @@ IterationResult solveSor(const Spmatrix& A, linear::VectorMutableView x,
     return {.error = error, .nIter = iter};
 }
 
+IterationResult solveSor(const Spmatrix& A, linear::VectorMutableView x,
+                         linear::VectorConstView b, Real w, Real tol,
+                         uint max_iter)
+{
+    return solveSorT(A, x, b, w, tol, max_iter);
+}
+
+IterationResult solveSor(const SpmatrixCompact& A,
+                         linear::VectorMutableView x,
+                         linear::VectorConstView b, Real w, Real tol,
+                         uint max_iter)
+{
+    return solveSorT(A, x, b, w, tol, max_iter);
+}
+
 }  // namespace sanity::splinear
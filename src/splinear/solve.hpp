@@ -1,4 +1,5 @@
 #pragma once
+#include "compact.hpp"
 #include "linear.hpp"
 #include "matrix.hpp"
 #include "type.hpp"
@@ -8,4 +9,8 @@ namespace sanity::splinear
 IterationResult solveSor(const Spmatrix& A, linear::VectorMutableView x,
                          linear::VectorConstView b, Real w, Real tol,
                          uint max_iter);
-}
+IterationResult solveSor(const SpmatrixCompact& A,
+                         linear::VectorMutableView x,
+                         linear::VectorConstView b, Real w, Real tol,
+                         uint max_iter);
+}  // namespace sanity::splinear
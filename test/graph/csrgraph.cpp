@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "graph.hpp"
+
+using namespace sanity::graph;
+
+TEST(graph, csr_from_digraph)
+{
+    DiGraph g(4);
+    g.addEdge(2, 0);
+    g.addEdge(0, 1);
+    g.addEdge(2, 3);
+    g.addEdge(0, 2);
+    CsrDiGraph csr(g);
+    ASSERT_EQ(csr.nodeCount(), 4);
+    ASSERT_EQ(csr.edgeCount(), 4);
+    for (uint i = 0; i < g.nodeCount(); i++)
+    {
+        const auto& edges = g.getNode(i).edges;
+        const auto& csr_edges = csr.getNode(i).edges;
+        ASSERT_EQ(csr_edges.size(), edges.size());
+        for (uint k = 0; k < edges.size(); k++)
+        {
+            ASSERT_EQ(csr_edges[k].eid, edges[k].eid);
+            ASSERT_EQ(csr_edges[k].dst, edges[k].dst);
+        }
+    }
+    auto sccs = decompScc(g);
+    auto csr_sccs = decompScc(csr);
+    ASSERT_EQ(csr_sccs.size(), sccs.size());
+    for (uint i = 0; i < sccs.size(); i++)
+    {
+        ASSERT_EQ(csr_sccs[i].nodes, sccs[i].nodes);
+        ASSERT_EQ(csr_sccs[i].isBottom, sccs[i].isBottom);
+    }
+}
+
+TEST(graph, csr_append)
+{
+    // nodes are discovered while the edges of earlier nodes are added
+    CsrDiGraph g;
+    g.addNode();
+    g.addNode();
+    ASSERT_EQ(g.addEdge(0, 1), 0);
+    ASSERT_EQ(g.getNode(0).edges.size(), 1);
+    ASSERT_TRUE(g.getNode(1).edges.empty());
+    g.addNode();
+    ASSERT_EQ(g.addEdge(0, 2), 1);
+    ASSERT_EQ(g.addEdge(2, 0), 2);
+    ASSERT_EQ(g.addEdge(2, 1), 3);
+    ASSERT_EQ(g.nodeCount(), 3);
+    ASSERT_EQ(g.edgeCount(), 4);
+    ASSERT_EQ(g.getNode(0).edges.size(), 2);
+    ASSERT_TRUE(g.getNode(1).edges.empty());
+    ASSERT_EQ(g.getNode(2).edges.size(), 2);
+    ASSERT_EQ(g.getNode(2).edges[1].dst, 1);
+    uint eid = 0;
+    for (uint i = 0; i < g.nodeCount(); i++)
+    {
+        for (const auto& edge : g.getNode(i).edges)
+        {
+            ASSERT_EQ(edge.eid, eid);
+            eid += 1;
+        }
+    }
+    auto sccs = decompScc(g);
+    ASSERT_EQ(sccs.size(), 2);
+    ASSERT_TRUE(sccs[0].isBottom);
+    ASSERT_EQ(sccs[0].nodes, std::vector<uint>({1}));
+}
+
+TEST(graph, structural_hash)
+{
+    DiGraph g(3);
+    g.addEdge(0, 1);
+    g.addEdge(1, 2);
+    g.addEdge(2, 0);
+    ASSERT_EQ(structuralHash(g), structuralHash(CsrDiGraph(g)));
+    DiGraph same(3);
+    same.addEdge(0, 1);
+    same.addEdge(1, 2);
+    same.addEdge(2, 0);
+    ASSERT_EQ(structuralHash(g), structuralHash(same));
+    DiGraph other(3);
+    other.addEdge(0, 1);
+    other.addEdge(1, 2);
+    other.addEdge(2, 1);
+    ASSERT_NE(structuralHash(g), structuralHash(other));
+    ASSERT_NE(structuralHash(g), structuralHash(DiGraph(3)));
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "graph.hpp"
+#include "simulate.hpp"
+
+using namespace sanity::graph;
+using namespace sanity::simulate;
+
+static DiGraph randomGraph(uint n, uint nedge, uint seed)
+{
+    UniformSampler sampler(seed);
+    DiGraph g(n);
+    for (uint k = 0; k < nedge; k++)
+    {
+        auto src = (uint)(sampler() * n);
+        auto dst = (uint)(sampler() * n);
+        g.addEdge(src, dst);
+    }
+    return g;
+}
+
+// sccs in a canonical order
+static std::vector<StronglyConnectedComponent> sorted(
+    std::vector<StronglyConnectedComponent> sccs)
+{
+    for (auto& scc : sccs)
+    {
+        std::sort(scc.nodes.begin(), scc.nodes.end());
+    }
+    std::sort(sccs.begin(), sccs.end(), [](const auto& s1, const auto& s2) {
+        return s1.nodes[0] < s2.nodes[0];
+    });
+    return sccs;
+}
+
+TEST(graph, scc)
+{
+    // 0 <-> 1 -> 2 <-> 3, 4 -> 4
+    DiGraph g(5);
+    g.addEdge(0, 1);
+    g.addEdge(1, 0);
+    g.addEdge(1, 2);
+    g.addEdge(2, 3);
+    g.addEdge(3, 2);
+    g.addEdge(4, 4);
+    auto sccs = decompScc(g);
+    ASSERT_EQ(sccs.size(), 3);
+    // reverse topological order
+    ASSERT_EQ(sccs[0].nodes, std::vector<uint>({3, 2}));
+    ASSERT_TRUE(sccs[0].isBottom);
+    ASSERT_EQ(sccs[1].nodes, std::vector<uint>({1, 0}));
+    ASSERT_FALSE(sccs[1].isBottom);
+    ASSERT_EQ(sccs[2].nodes, std::vector<uint>({4}));
+    ASSERT_TRUE(sccs[2].isBottom);
+}
+
+TEST(graph, scc_long_chain)
+{
+    // deep enough to overflow the stack of a recursive implementation
+    uint n = 2000000;
+    DiGraph g(n);
+    for (uint i = 0; i + 1 < n; i++)
+    {
+        g.addEdge(i, i + 1);
+    }
+    g.addEdge(n - 1, n / 2);
+    auto sccs = decompScc(g);
+    ASSERT_EQ(sccs.size(), n / 2 + 1);
+    ASSERT_EQ(sccs[0].nodes.size(), n / 2);
+    ASSERT_TRUE(sccs[0].isBottom);
+    ASSERT_FALSE(sccs.back().isBottom);
+    ASSERT_EQ(sorted(decompSccParallel(g, 2))[n / 2].nodes.size(), n / 2);
+}
+
+TEST(graph, scc_parallel)
+{
+    for (uint seed = 0; seed < 5; seed++)
+    {
+        auto g = randomGraph(2000, 2000 + 400 * seed, seed);
+        auto ref = sorted(decompScc(g));
+        for (uint nthread : {1u, 3u})
+        {
+            auto sccs = decompSccParallel(g, nthread);
+            ASSERT_EQ(sccs.size(), ref.size());
+            for (uint i = 0; i < ref.size(); i++)
+            {
+                ASSERT_EQ(sccs[i].nodes, ref[i].nodes);
+                ASSERT_EQ(sccs[i].isBottom, ref[i].isBottom);
+            }
+        }
+    }
+}
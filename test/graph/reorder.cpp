@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include "graph.hpp"
+
+using namespace sanity::graph;
+
+// largest distance between the positions of two adjacent nodes
+static uint bandwidth(const DiGraph& g, const sanity::linear::Permutation& p)
+{
+    uint bw = 0;
+    for (uint v = 0; v < g.nodeCount(); v++)
+    {
+        for (const auto& edge : g.getNode(v).edges)
+        {
+            int i = p.backward(v);
+            int j = p.backward(edge.dst);
+            bw = std::max(bw, (uint)std::abs(i - j));
+        }
+    }
+    return bw;
+}
+
+TEST(graph, reverse_cuthill_mckee)
+{
+    // a 20 x 20 grid with scrambled node ids, plus an isolated node
+    uint m = 20;
+    uint n = m * m;
+    auto id = [&](uint r, uint c) { return (r * m + c) * 7 % n; };
+    DiGraph g(n + 1);
+    for (uint r = 0; r < m; r++)
+    {
+        for (uint c = 0; c < m; c++)
+        {
+            if (c + 1 < m)
+            {
+                g.addEdge(id(r, c), id(r, c + 1));
+            }
+            if (r + 1 < m)
+            {
+                g.addEdge(id(r + 1, c), id(r, c));
+            }
+        }
+    }
+    auto p = reverseCuthillMckee(g);
+    std::vector<uint> nodes;
+    for (uint i = 0; i <= n; i++)
+    {
+        ASSERT_GE(p.forward(i), 0);
+        ASSERT_EQ(p.backward((uint)p.forward(i)), (int)i);
+        nodes.push_back((uint)p.forward(i));
+    }
+    std::sort(nodes.begin(), nodes.end());
+    for (uint i = 0; i <= n; i++)
+    {
+        ASSERT_EQ(nodes[i], i);
+    }
+    ASSERT_GT(bandwidth(g, sanity::linear::Permutation(n + 1)), 100);
+    // starting from a corner, every level is an anti-diagonal
+    ASSERT_LE(bandwidth(g, p), m);
+    auto csr_p = reverseCuthillMckee(CsrDiGraph(g));
+    ASSERT_EQ(bandwidth(g, csr_p), bandwidth(g, p));
+}
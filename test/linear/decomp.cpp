@@ -15,3 +15,47 @@ TEST(linear_decomp, QR1)
     std::cout << Q << std::endl;
     std::cout << R << std::endl;
 }
+
+TEST(linear_decomp, eigenvalues_hessenberg)
+{
+    auto H = createMatrix(3, 3,
+                          {
+                              1, -2, 0,  //
+                              2, 1, 0,   //
+                              0, 0, 3    //
+                          });
+    auto eigs = eigenvaluesHessenberg(H);
+    std::sort(eigs.begin(), eigs.end(), [](Complex a, Complex b) {
+        return a.real() < b.real() ||
+               (a.real() == b.real() && a.imag() < b.imag());
+    });
+    ASSERT_EQ(eigs.size(), 3);
+    ASSERT_NEAR(eigs[0].real(), 1.0, 1e-12);
+    ASSERT_NEAR(eigs[0].imag(), -2.0, 1e-12);
+    ASSERT_NEAR(eigs[1].real(), 1.0, 1e-12);
+    ASSERT_NEAR(eigs[1].imag(), 2.0, 1e-12);
+    ASSERT_NEAR(eigs[2].real(), 3.0, 1e-12);
+
+    // tridiagonal toeplitz, eigenvalues 2 - 2 cos(k pi / (n + 1))
+    uint n = 10;
+    Matrix T(n, n, 0.0);
+    for (uint i = 0; i < n; i++)
+    {
+        T(i, i) = 2.0;
+        if (i > 0)
+        {
+            T(i, i - 1) = -1.0;
+            T(i - 1, i) = -1.0;
+        }
+    }
+    auto teigs = eigenvaluesHessenberg(T);
+    std::sort(teigs.begin(), teigs.end(), [](Complex a, Complex b) {
+        return a.real() < b.real();
+    });
+    for (uint k = 1; k <= n; k++)
+    {
+        ASSERT_NEAR(teigs[k - 1].real(),
+                    2.0 - 2.0 * std::cos(k * M_PI / (n + 1)), 1e-10);
+        ASSERT_NEAR(teigs[k - 1].imag(), 0.0, 1e-10);
+    }
+}
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "parallel.hpp"
+
+using namespace sanity::parallel;
+
+TEST(parallel, parallel_for)
+{
+    for (uint nthread : {1u, 2u, 5u})
+    {
+        std::vector<uint> owner(103, 1000);
+        parallelFor(3, 103, nthread, [&](uint tid, uint begin, uint end) {
+            ASSERT_EQ(begin, blockBegin(3, 103, nthread, tid));
+            for (uint i = begin; i < end; i++)
+            {
+                owner[i] = tid;
+            }
+        });
+        ASSERT_EQ(owner[2], 1000);
+        ASSERT_EQ(owner[3], 0);
+        for (uint i = 4; i < 103; i++)
+        {
+            // contiguous blocks in thread order
+            ASSERT_LT(owner[i], nthread);
+            ASSERT_LE(owner[i - 1], owner[i]);
+        }
+    }
+}
+
+TEST(parallel, parallel_for_exception)
+{
+    ASSERT_THROW(parallelFor(0, 10, 4,
+                             [](uint tid, uint, uint) {
+                                 if (tid == 2)
+                                 {
+                                     throw std::invalid_argument("tid 2");
+                                 }
+                             }),
+                 std::invalid_argument);
+}
@@ -18,3 +18,32 @@ TEST(petrinet, gpn_create)
     ASSERT_EQ(gpn.placeCount(), 2);
     ASSERT_EQ(gpn.transProps.size(), 2);
 }
+
+TEST(petrinet, gpn_fire_in_place)
+{
+    GpnCreator creator;
+    auto p0 = creator.place(3);
+    auto p1 = creator.place(1);
+    auto t0 = creator.expTrans(1.0).iarc(p0).oarc(p1, 2).idx();
+    // moves every token of p0 to p1
+    auto all_p0 = [p0](PetriNetState st) { return st.marking->nToken(p0); };
+    auto t1 = creator.expTrans(1.0).iarc(p0, all_p0).oarc(p1, all_p0).idx();
+    auto gpn = creator.create();
+    Marking mk = creator.marking();
+
+    auto expected = gpn.fireTransition(t0, &mk);
+    gpn.fireTransitionInPlace(t0, mk);
+    ASSERT_TRUE(mk.equal(expected.get()));
+    ASSERT_EQ(mk.nToken(p0), 2);
+    ASSERT_EQ(mk.nToken(p1), 3);
+
+    expected = gpn.fireTransition(t1, &mk);
+    gpn.fireTransitionInPlace(t1, mk);
+    ASSERT_TRUE(mk.equal(expected.get()));
+    ASSERT_EQ(mk.nToken(p0), 0);
+    ASSERT_EQ(mk.nToken(p1), 5);
+
+    std::vector<uint> enabled = {7, 8, 9};
+    gpn.enabledTransitions(&mk, enabled);
+    ASSERT_EQ(enabled, gpn.enabledTransitions(&mk));
+}
@@ -16,7 +16,8 @@ TEST(petrinet, gpn_simulate_2place)
     creator.expTrans(2.0).iarc(1).oarc(0);
     auto gpn = creator.create();
     Marking init = creator.marking();
-    auto sim = gpnSimulator(gpn, init, UniformSampler());
+    auto sim =
+        gpnSimulator(gpn, init, UniformSampler(), GpnEngine::EventQueue);
     auto p0 = GpnObProbReward(0, 1000.0, [](PetriNetState state) {
         return state.marking->nToken(0);
     });
@@ -51,7 +52,8 @@ TEST(petrinet, gpn_simulate_2place_g_enable)
         [](auto state) { return gpnPlaceToken(state, 0) == 1; });
     auto gpn = creator.create();
     Marking init = creator.marking();
-    auto sim = gpnSimulator(gpn, init, UniformSampler());
+    auto sim =
+        gpnSimulator(gpn, init, UniformSampler(), GpnEngine::EventQueue);
     auto p0 = GpnObProbReward(0, 1000.0, [](PetriNetState state) {
         return state.marking->nToken(0);
     });
@@ -90,7 +92,8 @@ TEST(petrinet, gpn_simulate_2place_bitmarking)
     creator.expTrans(2.0).iarc(1).oarc(0);
     auto gpn = creator.create();
     auto init = creator.bitMarking();
-    auto sim = gpnSimulator(gpn, init, UniformSampler());
+    auto sim =
+        gpnSimulator(gpn, init, UniformSampler(), GpnEngine::EventQueue);
     auto p0 = GpnObProbReward(0, 1000.0, [](PetriNetState state) {
         return state.marking->nToken(0);
     });
@@ -127,7 +130,8 @@ TEST(petrinet, gpn_simulate_two_server_queue)
         auto gpn = creator.create();
         Marking init = creator.marking();
 
-        auto sim = gpnSimulator(gpn, init, UniformSampler());
+        auto sim =
+            gpnSimulator(gpn, init, UniformSampler(), GpnEngine::EventQueue);
 
         Real start = 0;
         Real end = 10000;
@@ -201,7 +205,8 @@ TEST(petrinet, gpn_simulate_two_server_queue_confidence)
         auto gpn = creator.create();
         Marking init = creator.marking();
 
-        auto sim = gpnSimulator(gpn, init, UniformSampler());
+        auto sim =
+            gpnSimulator(gpn, init, UniformSampler(), GpnEngine::EventQueue);
 
         Real start = 100;
         Real end = 200;
@@ -286,7 +291,8 @@ TEST(petrinet, gpn_simulate_two_server_queue_conversion)
 
     Interval queue_itv;
     {
-        auto sim = gpnSimulator(gpn, init, UniformSampler());
+        auto sim =
+            gpnSimulator(gpn, init, UniformSampler(), GpnEngine::EventQueue);
 
         Real start = 100;
         Real end = 200;
@@ -354,7 +360,8 @@ TEST(petrinet, gpn_molloy_thesis)
     auto gpn = ct.create();
     auto mk = ct.marking();
 
-    auto sim = gpnSimulator(gpn, mk, UniformSampler());
+    auto sim =
+        gpnSimulator(gpn, mk, UniformSampler(), GpnEngine::EventQueue);
 
     Real start = 0;
     Real end = 100;
@@ -426,7 +433,8 @@ TEST(petrinet, gpn_software_mtta)
     auto gpn = ct.create();
     auto mk = ct.byteMarking();
 
-    auto sim = gpnSimulator(gpn, mk, UniformSampler());
+    auto sim =
+        gpnSimulator(gpn, mk, UniformSampler(), GpnEngine::EventQueue);
 
     auto mtta_ob = GpnObMtta();
     sim.addObserver(mtta_ob);
@@ -471,7 +479,8 @@ TEST(petrinet, converted_gpn_software_mtta)
     auto gpn = ct.create();
     auto mk = ct.byteMarking();
 
-    auto sim = gpnSimulator(gpn, mk, UniformSampler());
+    auto sim =
+        gpnSimulator(gpn, mk, UniformSampler(), GpnEngine::EventQueue);
 
     auto mtta_ob = GpnObMtta();
     sim.addObserver(mtta_ob);
@@ -489,3 +498,418 @@ TEST(petrinet, converted_gpn_software_mtta)
     ASSERT_LT(itv.begin, 17.6701);
     ASSERT_GT(itv.end, 17.6701);
 }
+
+TEST(petrinet, gpn_software_mtta_resume)
+{
+    // the net of gpn_software_mtta with resumed timers; the transitions are
+    // exponential, so the mtta does not change
+    GpnCreator ct;
+    uint p0 = ct.place(4);
+    uint p1 = ct.place();
+    uint p2 = ct.place();
+    uint p3 = ct.place();
+    uint p4 = ct.place();
+    uint p5 = ct.place();
+    uint p6 = ct.place();
+    uint p7 = ct.place();
+    uint p8 = ct.place();
+
+    ct.immTrans(0.4).iarc(p3).oarc(p4);
+    ct.immTrans(0.6).iarc(p3).oarc(p5);
+    ct.immTrans(0.05).iarc(p7).oarc(p6);
+    ct.immTrans(0.95).iarc(p7).oarc(p5);
+    ct.immTrans(1.0).iarc(p2).iarc(p6).oarc(p8);
+    auto resume = GpnSamplePolicy::Resume;
+    ct.expTrans(1.0).policy(resume).iarc(p0).oarc(p1).oarc(p3);
+    ct.expTrans(0.3).policy(resume).iarc(p1).oarc(p2);
+    ct.expTrans(0.2).policy(resume).iarc(p4).oarc(p6);
+    ct.expTrans(7.0).policy(resume).iarc(p5).oarc(p7);
+
+    auto gpn = ct.create();
+    auto sim = gpnSimulator(gpn, ct.byteMarking(), UniformSampler(),
+                            GpnEngine::EventQueue);
+
+    auto mtta_ob = GpnObMtta();
+    sim.addObserver(mtta_ob);
+
+    uint nSample = 1000;
+    for (uint i = 0; i < nSample; i++)
+    {
+        sim.begin();
+        sim.runTillEnd();
+        sim.end();
+    }
+
+    auto itv = confidenceInterval(mtta_ob.samples(), 0.99);
+    std::cout << "mtta: " << itv << std::endl;
+    ASSERT_LT(itv.begin, 17.6701);
+    ASSERT_GT(itv.end, 17.6701);
+}
+
+TEST(petrinet, gpn_replications)
+{
+    GpnCreator ct;
+    auto p0 = ct.place(1);
+    auto p1 = ct.place();
+    auto p2 = ct.place();
+    auto p3 = ct.place();
+    auto p4 = ct.place();
+
+    ct.expTrans(1.0).iarc(p0).oarc(p1).oarc(p2);
+    ct.expTrans(3.0).iarc(p1).oarc(p3);
+    ct.expTrans(7.0).iarc(p2).oarc(p4);
+    ct.expTrans(9.0).iarc(p3).oarc(p1);
+    ct.expTrans(5.0).iarc(p3).iarc(p4).oarc(p0);
+
+    auto gpn = ct.create();
+    auto mk = ct.marking();
+    auto sim =
+        gpnSimulator(gpn, mk, UniformSampler(), GpnEngine::EventQueue);
+
+    Real end = 100;
+    auto mk_p0 = GpnObProbReward(0, end, gpnPlaceTokenFunc(p0));
+    auto counter = GpnObEventCounter();
+    uint nrep = 200;
+    auto [p0_1, counter_1] =
+        runReplications(sim, nrep, end, 7, 1, gpnReseed, mk_p0, counter);
+    auto [p0_4, counter_4] =
+        runReplications(sim, nrep, end, 7, 4, gpnReseed, mk_p0, counter);
+    ASSERT_EQ(p0_1.samples().size(), nrep);
+    ASSERT_EQ(p0_1.samples(), p0_4.samples());
+    ASSERT_EQ(counter_1.samples(), counter_4.samples());
+    // merged accumulators are reduced in the same order too
+    ASSERT_EQ(p0_1.stats().mean(), p0_4.stats().mean());
+    ASSERT_EQ(p0_1.stats().sampleVariance(), p0_4.stats().sampleVariance());
+
+    auto itv = confidenceInterval(p0_4.samples(), 0.99);
+    std::cout << "token in p0: " << itv << std::endl;
+    ASSERT_LT(itv.begin, 0.4497);
+    ASSERT_GT(itv.end, 0.4497);
+
+    // the observers attached to the prototype see nothing
+    sim.addObserver(mk_p0);
+    runReplications(sim, 10, end, 7, 2, gpnReseed, counter);
+    ASSERT_TRUE(mk_p0.samples().empty());
+}
+
+TEST(petrinet, gpn_direct_method)
+{
+    // M/M/1/5 queue whose arrivals are admitted by an immediate transition
+    GpnCreator ct;
+    auto arrived = ct.place();
+    auto queue = ct.place();
+    Real lambda = 1.0;
+    Real mu = 1.25;
+    ct.expTrans(lambda).harc(queue, 5).harc(arrived).oarc(arrived);
+    ct.immTrans().iarc(arrived).oarc(queue);
+    ct.expTrans(mu).iarc(queue);
+    auto gpn = ct.create();
+    auto mk = ct.marking();
+    ASSERT_TRUE(gpnDirectMethodApplies(gpn));
+
+    Real norm = 0;
+    Real expected = 0;
+    for (uint n = 0; n <= 5; n++)
+    {
+        norm += std::pow(lambda / mu, n);
+        expected += n * std::pow(lambda / mu, n);
+    }
+    expected /= norm;
+
+    for (auto engine : {GpnEngine::EventQueue, GpnEngine::DirectMethod})
+    {
+        auto sim = gpnSimulator(gpn, mk, UniformSampler(3), engine);
+        auto len = GpnObProbReward(0, 1000, gpnPlaceTokenFunc(queue));
+        sim.addObserver(len);
+        for (uint i = 0; i < 200; i++)
+        {
+            sim.begin();
+            sim.runFor(1000);
+            sim.end();
+        }
+        auto itv = confidenceInterval(len.samples(), 0.99);
+        std::cout << "queue length: " << itv << ", expected: " << expected
+                  << std::endl;
+        ASSERT_LT(itv.begin, expected);
+        ASSERT_GT(itv.end, expected);
+    }
+
+    GpnCreator dep;
+    auto p0 = dep.place(1);
+    dep.expTrans([=](PetriNetState st) { return st.marking->nToken(p0); })
+        .iarc(p0);
+    ASSERT_FALSE(gpnDirectMethodApplies(dep.create()));
+
+    GpnCreator general;
+    auto p1 = general.place(1);
+    general
+        .timedTrans(
+            [](PetriNetState, std::function<Real()>&) { return 1.0; })
+        .iarc(p1);
+    auto det = general.create();
+    ASSERT_FALSE(gpnDirectMethodApplies(det));
+    ASSERT_THROW(gpnSimulator(det, general.marking(), UniformSampler(),
+                              GpnEngine::DirectMethod),
+                 std::invalid_argument);
+}
+
+TEST(petrinet, gpn_tau_leap)
+{
+    // M/M/infinity queue with 1000 customers on average
+    GpnCreator ct;
+    auto queue = ct.place(1000);
+    Real lambda = 1000.0;
+    Real mu = 1.0;
+    ct.expTrans(lambda).oarc(queue);
+    ct.expTrans([=](PetriNetState st) {
+          return st.marking->nToken(queue) * mu;
+      }).iarc(queue);
+    auto gpn = ct.create();
+    ASSERT_TRUE(gpnTauLeapApplies(gpn));
+    ASSERT_FALSE(gpnDirectMethodApplies(gpn));
+
+    auto sim = gpnTauLeapSimulator(gpn, ct.marking(), UniformSampler(11));
+    auto len = GpnObProbReward(5, 10, gpnPlaceTokenFunc(queue));
+    auto counter = GpnObEventCounter();
+    sim.addObserver(len);
+    sim.addObserver(counter);
+    for (uint i = 0; i < 100; i++)
+    {
+        sim.begin();
+        sim.runFor(10);
+        sim.end();
+    }
+    auto itv = confidenceInterval(len.samples(), 0.99);
+    const auto& stats = sim.state().tauLeap.stats;
+    std::cout << "queue length: " << itv << ", events per run: "
+              << mean(counter.samples()) << ", leaps: " << stats.leaps
+              << ", leap firings: " << stats.leapFirings
+              << ", exact steps: " << stats.exactSteps
+              << ", rejections: " << stats.rejections << std::endl;
+    ASSERT_NEAR(itv.center(), lambda / mu, 5.0);
+    // 20000 firings per run if simulated exactly
+    ASSERT_LT(mean(counter.samples()), 2000);
+
+    // pure death process, absorbed after H(100) time units on average
+    GpnCreator death;
+    auto alive = death.place(100);
+    death.expTrans([=](PetriNetState st) {
+             return (Real)st.marking->nToken(alive);
+         }).iarc(alive);
+    auto death_sim = gpnTauLeapSimulator(death.create(), death.marking(),
+                                         UniformSampler(5));
+    auto mtta = GpnObMtta();
+    death_sim.addObserver(mtta);
+    for (uint i = 0; i < 500; i++)
+    {
+        death_sim.begin();
+        death_sim.runTillEnd();
+        death_sim.end();
+        ASSERT_EQ(death_sim.state().currMarking->nToken(alive), 0);
+    }
+    Real harmonic = 0;
+    for (uint k = 1; k <= 100; k++)
+    {
+        harmonic += 1.0 / k;
+    }
+    auto mtta_itv = confidenceInterval(mtta.samples(), 0.99);
+    std::cout << "time to absorption: " << mtta_itv
+              << ", expected: " << harmonic << std::endl;
+    ASSERT_NEAR(mtta_itv.center(), harmonic, 0.3);
+    ASSERT_GT(death_sim.state().tauLeap.stats.exactSteps, 0);
+
+    // a transition that needs two tokens and puts one back stops at one
+    // token; long leaps must not run it down to zero
+    GpnCreator self_loop;
+    auto pool = self_loop.place(50);
+    self_loop
+        .expTrans([=](PetriNetState st) {
+            return (Real)st.marking->nToken(pool);
+        })
+        .iarc(pool, 2)
+        .oarc(pool, 1);
+    GpnTauLeapOptions coarse;
+    coarse.epsilon = 1.0;
+    coarse.criticalFirings = 1;
+    coarse.exactStepFactor = 0.0;
+    auto loop_sim = gpnTauLeapSimulator(self_loop.create(),
+                                        self_loop.marking(),
+                                        UniformSampler(3), coarse);
+    for (uint i = 0; i < 500; i++)
+    {
+        loop_sim.begin();
+        loop_sim.runTillEnd();
+        loop_sim.end();
+        ASSERT_EQ(loop_sim.state().currMarking->nToken(pool), 1);
+    }
+    ASSERT_GT(loop_sim.state().tauLeap.stats.rejections, 0);
+}
+
+TEST(petrinet, gpn_run_until_precise)
+{
+    GpnCreator ct;
+    auto p0 = ct.place(1);
+    auto p1 = ct.place();
+    ct.expTrans(1.0).iarc(p0).oarc(p1);
+    ct.expTrans(2.0).iarc(p1).oarc(p0);
+    auto gpn = ct.create();
+    auto sim = gpnSimulator(gpn, ct.marking(), UniformSampler());
+
+    Real end = 10;
+    auto tokens = GpnObProbReward(0, end, gpnPlaceTokenFunc(p0));
+    auto events = GpnObEventCounter();
+    SequentialOptions options;
+    options.relativeHalfWidth = 0.01;
+    options.minReplications = 20;
+    auto res = runUntilPrecise(sim, options, end, 3, 2, gpnReseed, tokens,
+                               events);
+    const auto& [tokens_res, events_res] = res.observers;
+    std::cout << "replications: " << res.replications << std::endl;
+    ASSERT_TRUE(res.converged);
+    ASSERT_GT(res.replications, options.minReplications);
+    ASSERT_EQ(tokens_res.samples().size(), res.replications);
+    ASSERT_LE(relativeHalfWidth(tokens_res.samples(), 0.95), 0.01);
+    ASSERT_LE(relativeHalfWidth(events_res.samples(), 0.95), 0.01);
+    ASSERT_NEAR(mean(tokens_res.samples()), 2.0 / 3.0, 0.02);
+
+    // the same streams in one go give the same samples
+    auto [tokens_all] = runReplications(sim, res.replications, end, 3, 1,
+                                        gpnReseed, tokens);
+    ASSERT_EQ(tokens_all.samples(), tokens_res.samples());
+
+    options.relativeHalfWidth = 1e-6;
+    options.maxReplications = 100;
+    auto capped = runUntilPrecise(sim, options, end, 3, 2, gpnReseed, tokens);
+    ASSERT_FALSE(capped.converged);
+    ASSERT_EQ(capped.replications, 100);
+}
+
+TEST(petrinet, gpn_batch_means)
+{
+    // M/M/1/50 queue that starts full, far from its mean queue length; it
+    // takes about cap / (mu - lambda) = 50 time units to drain
+    GpnCreator ct;
+    uint cap = 50;
+    auto queue = ct.place(cap);
+    Real lambda = 1.0;
+    Real mu = 2.0;
+    ct.expTrans(lambda).harc(queue, cap).oarc(queue);
+    ct.expTrans(mu).iarc(queue);
+    auto gpn = ct.create();
+
+    Real norm = 0;
+    Real expected = 0;
+    for (uint n = 0; n <= cap; n++)
+    {
+        norm += std::pow(lambda / mu, n);
+        expected += n * std::pow(lambda / mu, n);
+    }
+    expected /= norm;
+
+    auto sim = gpnSimulator(gpn, ct.marking(), UniformSampler(5));
+    auto len = GpnObBatchMeans(1, gpnPlaceTokenFunc(queue), 25);
+    sim.addObserver(len);
+    sim.begin();
+    sim.runFor(10000);
+    sim.end();
+    ASSERT_EQ(len.observations().size(), 10000);
+    ASSERT_EQ(len.samples().size(), 25);
+    auto itv = confidenceInterval(len.samples(), 0.99);
+    std::cout << "queue length: " << itv << ", expected: " << expected
+              << ", warm-up: " << len.warmUpTime() << std::endl;
+    ASSERT_LT(itv.begin, expected);
+    ASSERT_GT(itv.end, expected);
+    // the drain is cut off, well within half of the run
+    ASSERT_GT(len.warmUpTime(), 0);
+    ASSERT_LE(len.warmUpTime(), 1000);
+
+    // a second run appends its batches
+    sim.begin();
+    sim.runFor(10000);
+    sim.end();
+    ASSERT_EQ(len.samples().size(), 50);
+
+    ASSERT_THROW(GpnObBatchMeans(0, gpnPlaceTokenFunc(queue)),
+                 std::invalid_argument);
+}
+
+TEST(petrinet, gpn_splitting)
+{
+    // birth-death chain from 1 token, absorbed at 0; the probability of
+    // reaching 15 tokens first is the gambler's ruin (r - 1) / (r^15 - 1)
+    // with r = mu / lambda
+    GpnCreator ct;
+    auto p0 = ct.place(1);
+    Real lambda = 1.0;
+    Real mu = 4.0;
+    ct.expTrans(lambda).iarc(p0).oarc(p0, 2);
+    ct.expTrans(mu).iarc(p0);
+    auto gpn = ct.create();
+    auto sim = gpnSimulator(gpn, ct.marking(), UniformSampler());
+    Real ratio = mu / lambda;
+    Real expected = (ratio - 1) / (std::pow(ratio, 15) - 1);
+
+    std::vector<Real> levels;
+    for (uint k = 2; k <= 15; k++)
+    {
+        levels.push_back(k);
+    }
+    SplittingOptions options;
+    options.effort = 500;
+    options.repetitions = 20;
+    auto res = gpnSplitting(sim, gpnPlaceTokenFunc(p0), levels, INFINITY,
+                            options, 7, 2);
+    ASSERT_EQ(res.estimates.size(), 20);
+    ASSERT_EQ(res.levelProbabilities.size(), levels.size());
+    auto itv = confidenceInterval(res.estimates, 0.99);
+    std::cout << "probability: " << itv << ", expected: " << expected
+              << std::endl;
+    ASSERT_LT(itv.begin, expected);
+    ASSERT_GT(itv.end, expected);
+    // from 2 tokens, 3 is reached before 0 with probability 5 / 21
+    ASSERT_NEAR(res.levelProbabilities[1], 5.0 / 21.0, 0.03);
+
+    auto again = gpnSplitting(sim, gpnPlaceTokenFunc(p0), levels, INFINITY,
+                              options, 7, 1);
+    ASSERT_EQ(again.estimates, res.estimates);
+
+    // within a short horizon the event is rarer still
+    auto timed = gpnSplitting(sim, gpnPlaceTokenFunc(p0), levels, 5.0,
+                              options, 7, 2);
+    ASSERT_LT(mean(timed.estimates), mean(res.estimates));
+
+    ASSERT_THROW(gpnSplitting(sim, gpnPlaceTokenFunc(p0), {3, 2}, INFINITY,
+                              options, 7),
+                 std::invalid_argument);
+}
+
+TEST(petrinet, gpn_streaming_stats)
+{
+    GpnCreator ct;
+    auto p0 = ct.place(1);
+    auto p1 = ct.place();
+    ct.expTrans(1.0).iarc(p0).oarc(p1);
+    ct.expTrans(2.0).iarc(p1).oarc(p0);
+    auto sim = gpnSimulator(ct.create(), ct.marking(), UniformSampler());
+
+    auto kept = GpnObProbReward(0, 10, gpnPlaceTokenFunc(p0));
+    kept.sketchQuantiles(true);
+    auto streamed = kept;
+    streamed.keepSamples(false);
+    auto [kept_res, streamed_res] =
+        runReplications(sim, 2000, 10, 9, 2, gpnReseed, kept, streamed);
+    ASSERT_EQ(kept_res.samples().size(), 2000);
+    ASSERT_TRUE(streamed_res.samples().empty());
+    ASSERT_EQ(streamed_res.stats().count(), 2000);
+    auto itv = confidenceInterval(streamed_res.stats(), 0.99);
+    auto expected = confidenceInterval(kept_res.samples(), 0.99);
+    std::cout << "token in p0: " << itv << std::endl;
+    ASSERT_NEAR(itv.begin, expected.begin, 1e-9);
+    ASSERT_NEAR(itv.end, expected.end, 1e-9);
+
+    auto sorted = kept_res.samples();
+    std::sort(sorted.begin(), sorted.end());
+    Real median = streamed_res.quantiles().quantile(0.5);
+    ASSERT_GE(median, sorted[900]);
+    ASSERT_LE(median, sorted[1100]);
+}
@@ -32,6 +32,176 @@ TEST(petrinet, srn_birthdeath_sor)
     ASSERT_NEAR(prob(0), 0.9, 1e-6);
 }
 
+TEST(petrinet, srn_birthdeath_sor_mixed)
+{
+    SrnCreator ct;
+    auto p_live = ct.place();
+    auto p_dead = ct.place();
+    ct.expTrans(1.0).iarc(p_live).oarc(p_dead);
+    ct.expTrans(10.0).iarc(p_dead).oarc(p_live);
+    auto srn = ct.create();
+    Marking mk(2);
+    mk.setToken(p_live, 10);
+    auto rg = genReducedReachGraph(srn, mk);
+    auto Q = srnRateMatrix(rg.graph, rg.edgeRates);
+    auto prob = Vector(rg.nodeMarkings.size(), 1.0);
+    auto iter =
+        srnSteadyStateSorMixed(Q, mutableView(prob), 1.0, 1e-10, 1000);
+    std::cout << "mixed sor nIter: " << iter.nIter
+              << ", error: " << iter.error << std::endl;
+    ASSERT_LT(iter.error, 1e-10);
+    ASSERT_NEAR(prob(0), 0.9, 1e-9);
+    auto prob_sor = Vector(rg.nodeMarkings.size(), 1.0);
+    srnSteadyStateSor(Q, mutableView(prob_sor), 1.0, 1e-12, 1000);
+    ASSERT_LT(maxDiff(prob, prob_sor), 1e-9);
+}
+
+TEST(petrinet, srn_sor_reorder)
+{
+    // two independent machines with repair
+    SrnCreator ct;
+    for (uint k = 0; k < 2; k++)
+    {
+        auto p_live = ct.place(3);
+        auto p_dead = ct.place();
+        ct.expTrans(1.0 + k).iarc(p_live).oarc(p_dead);
+        ct.expTrans(5.0).iarc(p_dead).oarc(p_live);
+    }
+    auto srn = ct.create();
+    auto rg = genReducedReachGraph(srn, ct.marking());
+    auto ref = srnSteadyStateSor(rg.graph, rg.edgeRates, 1.0, 1e-12, 1000);
+    auto sol =
+        srnSteadyStateSor(rg.graph, rg.edgeRates, 1.0, 1e-12, 1000, true);
+    for (uint node = 0; node < rg.graph.nodeCount(); node++)
+    {
+        ASSERT_NEAR(
+            sol.solution((uint)sol.matrix2node.backward(node)),
+            ref.solution((uint)ref.matrix2node.backward(node)), 1e-10);
+    }
+}
+
+TEST(petrinet, srn_birthdeath_sor_batch)
+{
+    SrnCreator ct;
+    auto p_live = ct.place(10);
+    auto p_dead = ct.place();
+    ct.expTrans(1.0).iarc(p_live).oarc(p_dead);
+    ct.expTrans(10.0).iarc(p_dead).oarc(p_live);
+    auto rg = genReducedReachGraph(ct.create(), ct.marking());
+    uint n = rg.graph.nodeCount();
+    // scale the repair rates of every lane
+    std::vector<std::vector<Real>> lane_rates;
+    for (Real factor : {1.0, 0.5, 2.0, 4.0})
+    {
+        auto rates = rg.edgeRates;
+        for (uint e = 1; e < rates.size(); e += 2)
+        {
+            rates[e] *= factor;
+        }
+        lane_rates.push_back(rates);
+    }
+    uint K = lane_rates.size();
+    auto pattern = srnRateMatrixPattern(rg.graph, rg.edgeRates);
+    auto Q = spmatrixBatch(pattern, lane_rates);
+    Matrix prob(n, K, 1.0);
+    auto res = srnSteadyStateSorBatch(Q, mutableView(prob), 1.0, 1e-10, 1000);
+    // uniformized P = I + Q / q
+    auto P = Q;
+    Real q = 50.0;
+    for (uint i = 0; i < n; i++)
+    {
+        for (uint k = P.ptr[i]; k < P.ptr[i + 1]; k++)
+        {
+            for (uint lane = 0; lane < K; lane++)
+            {
+                Real& v = P.val[k * K + lane];
+                v = v / q + (P.idx[k] == i ? 1.0 : 0.0);
+            }
+        }
+    }
+    Matrix prob_power(n, K, 1.0);
+    auto res_power =
+        srnSteadyStatePowerBatch(P, mutableView(prob_power), 1e-12, 100000);
+    for (uint lane = 0; lane < K; lane++)
+    {
+        ASSERT_LT(res[lane].error, 1e-10);
+        ASSERT_LT(res_power[lane].error, 1e-12);
+        for (uint i = 0; i < n; i++)
+        {
+            ASSERT_NEAR(prob_power(i, lane), prob(i, lane), 1e-8);
+        }
+        updateValues(pattern, lane_rates[lane]);
+        auto ref = Vector(n, 1.0);
+        auto ref_res = srnSteadyStateSor(pattern.matrix, mutableView(ref),
+                                         1.0, 1e-10, 1000);
+        ASSERT_EQ(res[lane].nIter, ref_res.nIter);
+        for (uint i = 0; i < n; i++)
+        {
+            ASSERT_NEAR(prob(i, lane), ref(i), 1e-12);
+        }
+    }
+}
+
+TEST(petrinet, srn_birthdeath_check_interval)
+{
+    SrnCreator ct;
+    auto p_live = ct.place(20);
+    auto p_dead = ct.place();
+    ct.expTrans(1.0).iarc(p_live).oarc(p_dead);
+    ct.expTrans(4.0).iarc(p_dead).oarc(p_live);
+    auto rg = genReducedReachGraph(ct.create(), ct.marking());
+    uint n = rg.graph.nodeCount();
+    auto Q = srnRateMatrix(rg.graph, rg.edgeRates);
+    // uniformized P = I + Q / q
+    auto P = Q;
+    Real q = 100.0;
+    for (uint i = 0; i < n; i++)
+    {
+        for (uint k = P.ptr[i]; k < P.ptr[i + 1]; k++)
+        {
+            P.val[k] = P.val[k] / q + (P.idx[k] == i ? 1.0 : 0.0);
+        }
+    }
+    Vector sor(n, 1.0);
+    auto sor_res = srnSteadyStateSor(Q, mutableView(sor), 1.2, 1e-12, 1000);
+    Vector power(n, 1.0);
+    auto power_res =
+        srnSteadyStatePower(P, mutableView(power), 1e-14, 100000);
+    ASSERT_LT(power_res.error, 1e-14);
+    for (uint i = 0; i < n; i++)
+    {
+        ASSERT_NEAR(power(i), sor(i), 1e-9);
+    }
+    for (uint k : {2u, 7u})
+    {
+        Vector sor_k(n, 1.0);
+        auto sor_k_res =
+            srnSteadyStateSor(Q, mutableView(sor_k), 1.2, 1e-12, 1000, k);
+        ASSERT_LT(sor_k_res.error, 1e-12);
+        ASSERT_EQ(sor_k_res.nIter % k, 0);
+        ASSERT_GE(sor_k_res.nIter, sor_res.nIter);
+        ASSERT_LT(sor_k_res.nIter, sor_res.nIter + k);
+        Vector power_k(n, 1.0);
+        auto power_k_res =
+            srnSteadyStatePower(P, mutableView(power_k), 1e-14, 100000, k);
+        ASSERT_LT(power_k_res.error, 1e-14);
+        Real sum = 0.0;
+        for (uint i = 0; i < n; i++)
+        {
+            ASSERT_NEAR(sor_k(i), sor(i), 1e-10);
+            ASSERT_NEAR(power_k(i), power(i), 1e-10);
+            sum += power_k(i);
+        }
+        ASSERT_NEAR(sum, 1.0, 1e-12);
+    }
+    // stopped by max_iter on an unchecked iteration
+    Vector capped(n, 1.0);
+    auto capped_res =
+        srnSteadyStatePower(P, mutableView(capped), 0.0, 10, 4);
+    ASSERT_EQ(capped_res.nIter, 11);
+    ASSERT_FALSE(std::isnan(capped_res.error));
+}
+
 TEST(petrinet, srn_birthdeath_decomp)
 {
     SrnCreator ct;
@@ -139,6 +309,114 @@ TEST(petrinet, srn_two_absoring_decomp)
     ASSERT_NEAR(sol.solution((uint)sol.matrix2node.backward(2)), 0.75, 1e-6);
 }
 
+TEST(petrinet, srn_two_absoring_decomp_pattern)
+{
+    SrnCreator ct;
+    auto p_start = ct.place();
+    auto p_end1 = ct.place();
+    auto p_end2 = ct.place();
+    ct.expTrans(2.5).iarc(p_start).oarc(p_end1);
+    ct.expTrans(7.5).iarc(p_start).oarc(p_end2);
+    auto srn = ct.create();
+
+    Marking mk(srn.placeCount());
+    mk.setToken(p_start, 1);
+
+    auto rg = genReducedReachGraph(srn, mk);
+    uint max_iter = 100;
+    Real tol = 1e-6;
+    Real w = 1;
+    auto solver = [=](const Spmatrix& A, VectorMutableView x,
+                      VectorConstView b) {
+        auto res = solveSor(A, x, b, w, tol, max_iter);
+        if (res.error > tol || std::isnan(res.error))
+        {
+            throw std::invalid_argument("Sor failed to converge.");
+        }
+    };
+    auto pattern = srnSteadyStateDecompPattern(rg.graph, rg.edgeRates);
+    std::vector<Real> rates = rg.edgeRates;
+    for (Real scale : {1.0, 3.0, 0.5})
+    {
+        // swap the two rates and scale them
+        rates[0] = rg.edgeRates[1] * scale;
+        rates[1] = rg.edgeRates[0] * scale;
+        auto sol = srnSteadyStateDecomp(pattern, rates, rg.initProbs, solver);
+        auto ref =
+            srnSteadyStateDecomp(rg.graph, rates, rg.initProbs, solver);
+        for (uint i = 0; i < rg.graph.nodeCount(); i++)
+        {
+            ASSERT_NEAR(sol.solution(i), ref.solution(i), 1e-12);
+        }
+        ASSERT_NEAR(sol.solution((uint)sol.matrix2node.backward(0)),
+                    0.1 / scale, 1e-6);
+    }
+
+    auto Q = srnRateMatrix(rg.graph, rates);
+    auto Qpat = srnRateMatrixPattern(rg.graph, rg.edgeRates);
+    updateValues(Qpat, rates);
+    for (uint i = 0; i < Q.nrow; i++)
+    {
+        for (uint j = 0; j < Q.ncol; j++)
+        {
+            ASSERT_EQ(SpmatrixGet(Q, i, j), SpmatrixGet(Qpat.matrix, i, j));
+        }
+    }
+}
+
+TEST(petrinet, srn_many_absoring_decomp_parallel)
+{
+    // a job picks one of four servers and stays there forever, each server
+    // being a birth-death chain of its own
+    SrnCreator ct;
+    auto p_start = ct.place(1);
+    for (uint k = 0; k < 4; k++)
+    {
+        auto p_up = ct.place();
+        auto p_down = ct.place();
+        ct.expTrans(1.0 + k).iarc(p_start).oarc(p_up);
+        ct.expTrans(1.0).iarc(p_up).oarc(p_down);
+        ct.expTrans(3.0).iarc(p_down).oarc(p_up);
+    }
+    auto srn = ct.create();
+    auto rg = genReducedReachGraph(srn, ct.marking());
+    auto solver = [](const Spmatrix& A, VectorMutableView x,
+                     VectorConstView b) {
+        auto res = solveSor(A, x, b, 1.0, 1e-12, 1000);
+        if (res.error > 1e-12 || std::isnan(res.error))
+        {
+            throw std::invalid_argument("Sor failed to converge.");
+        }
+    };
+    auto ref = srnSteadyStateDecomp(rg.graph, rg.edgeRates, rg.initProbs,
+                                    solver);
+    ASSERT_EQ(ref.absGroupSizes.size(), 4);
+    auto sol = srnSteadyStateDecomp(rg.graph, rg.edgeRates, rg.initProbs,
+                                    solver, 3);
+    ASSERT_EQ(sol.nTransient, 1);
+    Real total = 0.0;
+    for (uint i = 0; i < rg.graph.nodeCount(); i++)
+    {
+        ASSERT_EQ(sol.solution(i), ref.solution(i));
+        if (i >= sol.nTransient)
+        {
+            total += sol.solution(i);
+        }
+    }
+    ASSERT_NEAR(total, 1.0, 1e-10);
+    // expected time in the start state
+    ASSERT_NEAR(sol.solution(0), 1.0 / 10.0, 1e-10);
+
+    // every bottom scc only carries its own up and down edges
+    auto pattern = srnSteadyStateDecompPattern(rg.graph, rg.edgeRates, 3);
+    ASSERT_EQ(pattern.QAA.size(), 4);
+    for (const auto& qaa : pattern.QAA)
+    {
+        ASSERT_EQ(qaa.valueMap.keys.size(), 2);
+        ASSERT_LE(qaa.valueMap.pos.size(), 4);
+    }
+}
+
 static void printSrnSol(
     const std::vector<std::unique_ptr<MarkingIntf>>& markings,
     const Permutation& mat2node, uint ntan, VectorConstView solution)
@@ -481,3 +759,322 @@ TEST(petrinet, srn_ts_acyclic1)
         ASSERT_NEAR(sol(2), 1.0, 1e-6);
     }
 }
+
+TEST(petrinet, srn_solution_cache)
+{
+    SrnSolutionCache cache;
+    auto cold = cache.initialGuess(1, 3);
+    ASSERT_EQ(cold.size(), 3);
+    ASSERT_EQ(cold(0), 1.0);
+    cache.store(1, createVector(3, {0.2, 0.3, 0.5}));
+    auto prev = cache.initialGuess(1, 3);
+    ASSERT_EQ(prev(1), 0.3);
+    // a different size is a cold start
+    ASSERT_EQ(cache.initialGuess(1, 2)(0), 1.0);
+    cache.store(1, createVector(3, {0.1, 0.5, 0.4}));
+    // 2 * x1 - x0 = (0, 0.7, 0.3)
+    auto guess = cache.initialGuess(1, 3);
+    ASSERT_NEAR(guess(0), 0.0, 1e-15);
+    ASSERT_NEAR(guess(1), 0.7, 1e-15);
+    ASSERT_NEAR(guess(2), 0.3, 1e-15);
+    cache.store(1, createVector(3, {0.0, 0.9, 0.1}));
+    // (-0.1, 1.3, -0.2) is clipped and normalized
+    guess = cache.initialGuess(1, 3);
+    ASSERT_EQ(guess(0), 0.0);
+    ASSERT_NEAR(guess(1), 1.0, 1e-15);
+    ASSERT_EQ(guess(2), 0.0);
+    SrnSolutionCache prev_cache(SrnSolutionCache::Guess::Previous);
+    prev_cache.store(1, createVector(3, {0.1, 0.5, 0.4}));
+    prev_cache.store(1, createVector(3, {0.0, 0.9, 0.1}));
+    ASSERT_EQ(prev_cache.initialGuess(1, 3)(1), 0.9);
+    ASSERT_EQ(cache.size(), 1);
+    cache.clear();
+    ASSERT_FALSE(cache.contains(1));
+}
+
+TEST(petrinet, srn_sweep_warm_start)
+{
+    uint site_count = 3;
+    uint max_job = 8;
+    SrnCreator crt;
+    crt.expTrans(1.0).oarc(0).harc(0, max_job);
+    crt.place(0);
+    for (uint i = 1; i < site_count; i++)
+    {
+        crt.expTrans(1.5).iarc(i - 1).oarc(i).harc(i, max_job);
+        crt.place(1);
+    }
+    crt.expTrans(1.5).iarc(site_count - 1);
+    auto rg = genReducedReachGraph(crt.create(), crt.marking());
+    uint n = rg.graph.nodeCount();
+    auto key = sanity::graph::structuralHash(rg.graph);
+    auto Q = srnRateMatrixPattern(rg.graph, rg.edgeRates);
+    SrnSolutionCache cache;
+    uint cold_iter = 0;
+    uint warm_iter = 0;
+    std::vector<Real> rates = rg.edgeRates;
+    for (uint k = 0; k < 10; k++)
+    {
+        rates[0] = rg.edgeRates[0] * (1.0 + 0.02 * k);
+        updateValues(Q, rates);
+        Vector cold(n, 1.0);
+        cold_iter +=
+            srnSteadyStateSor(Q.matrix, mutableView(cold), 1.0, 1e-10, 10000)
+                .nIter;
+        auto warm = cache.initialGuess(key, n);
+        warm_iter +=
+            srnSteadyStateSor(Q.matrix, mutableView(warm), 1.0, 1e-10, 10000)
+                .nIter;
+        cache.store(key, warm);
+        for (uint i = 0; i < n; i++)
+        {
+            ASSERT_NEAR(warm(i), cold(i), 1e-8);
+        }
+
+        auto sol = srnSteadyStateSor(rg.graph, rates, cold, 1.0, 1e-10, 10);
+        for (uint i = 0; i < n; i++)
+        {
+            ASSERT_NEAR(sol.solution(i), cold(i), 1e-9);
+        }
+    }
+    std::cout << "cold nIter: " << cold_iter << ", warm nIter: " << warm_iter
+              << std::endl;
+    ASSERT_LT(warm_iter, cold_iter);
+}
+
+TEST(petrinet, srn_two_absoring_decomp_guess)
+{
+    SrnCreator ct;
+    auto p_start = ct.place();
+    auto p_mid = ct.place();
+    auto p_end1 = ct.place();
+    auto p_end2 = ct.place();
+    ct.expTrans(2.0).iarc(p_start).oarc(p_mid);
+    ct.expTrans(1.0).iarc(p_mid).oarc(p_start);
+    ct.expTrans(2.5).iarc(p_mid).oarc(p_end1);
+    ct.expTrans(7.5).iarc(p_mid).oarc(p_end2);
+    auto srn = ct.create();
+    Marking mk(srn.placeCount());
+    mk.setToken(p_start, 1);
+    auto rg = genReducedReachGraph(srn, mk);
+
+    Real tol = 1e-12;
+    uint total_iter = 0;
+    auto solver = [&](const Spmatrix& A, VectorMutableView x,
+                      VectorConstView b) {
+        auto res = solveSor(A, x, b, 1.0, tol, 1000);
+        if (res.error > tol || std::isnan(res.error))
+        {
+            throw std::invalid_argument("Sor failed to converge.");
+        }
+        total_iter += res.nIter;
+    };
+    auto ref = srnSteadyStateDecomp(rg.graph, rg.edgeRates, rg.initProbs,
+                                    solver);
+    uint cold_iter = total_iter;
+    total_iter = 0;
+    auto pattern = srnSteadyStateDecompPattern(rg.graph, rg.edgeRates);
+    auto sol = srnSteadyStateDecomp(pattern, rg.edgeRates, rg.initProbs,
+                                    ref.solution, solver);
+    ASSERT_LT(total_iter, cold_iter);
+    for (uint i = 0; i < rg.graph.nodeCount(); i++)
+    {
+        ASSERT_NEAR(sol.solution(i), ref.solution(i), 1e-10);
+    }
+    auto sol2 = srnSteadyStateDecomp(rg.graph, rg.edgeRates, rg.initProbs,
+                                     Vector(rg.graph.nodeCount(), 0.0),
+                                     solver);
+    for (uint i = 0; i < rg.graph.nodeCount(); i++)
+    {
+        ASSERT_NEAR(sol2.solution(i), ref.solution(i), 1e-10);
+    }
+    ASSERT_THROW(srnSteadyStateDecomp(rg.graph, rg.edgeRates, rg.initProbs,
+                                      Vector(1, 1.0), solver),
+                 std::invalid_argument);
+}
+
+TEST(petrinet, srn_matrix_free_generator)
+{
+    uint site_count = 3;
+    uint max_job = 4;
+    SrnCreator crt;
+    crt.expTrans(1.0).oarc(0).harc(0, max_job);
+    crt.place(0);
+    for (uint i = 1; i < site_count; i++)
+    {
+        crt.expTrans(1.5).iarc(i - 1).oarc(i).harc(i, max_job);
+        crt.place(1);
+    }
+    crt.expTrans([=](PetriNetState st) {
+           return 2.0 * st.marking->nToken(site_count - 1);
+       })
+        .iarc(site_count - 1);
+    auto srn = crt.create();
+    auto rg = genReducedReachGraph(srn, crt.marking());
+    SrnGenerator gen(srn, crt.marking());
+    uint n = gen.stateCount();
+    ASSERT_EQ(n, rg.graph.nodeCount());
+    // same state order as the reachability graph, so same matrix
+    auto Q = srnRateMatrix(rg.graph, rg.edgeRates);
+    for (uint i = 0; i < n; i++)
+    {
+        ASSERT_TRUE(gen.marking(i)->equal(rg.nodeMarkings[i].get()));
+        ASSERT_EQ(gen.find(rg.nodeMarkings[i].get()), (int)i);
+    }
+    Vector v(n);
+    for (uint i = 0; i < n; i++)
+    {
+        v(i) = 1.0 + i;
+    }
+    Vector x(n);
+    Vector ref(n);
+    gen.dot(v, mutableView(x));
+    dot(Q, v, mutableView(ref));
+    for (uint i = 0; i < n; i++)
+    {
+        ASSERT_NEAR(x(i), ref(i), 1e-12);
+    }
+
+    Vector sor(n, 1.0);
+    srnSteadyStateSor(Q, mutableView(sor), 1.0, 1e-12, 10000);
+    Vector power(n, 1.0);
+    auto power_res =
+        srnSteadyStatePower(gen, mutableView(power), 1e-12, 100000);
+    ASSERT_LT(power_res.error, 1e-12);
+    Vector jacobi(n, 1.0);
+    auto jacobi_res =
+        srnSteadyStateJacobi(gen, mutableView(jacobi), 0.8, 1e-12, 10000);
+    ASSERT_LT(jacobi_res.error, 1e-12);
+    for (uint i = 0; i < n; i++)
+    {
+        ASSERT_NEAR(power(i), sor(i), 1e-8);
+        ASSERT_NEAR(jacobi(i), sor(i), 1e-8);
+    }
+
+    SrnCreator imm;
+    auto p0 = imm.place(1);
+    auto p1 = imm.place();
+    imm.expTrans(1.0).iarc(p0).oarc(p1);
+    imm.immTrans().iarc(p1).oarc(p0);
+    auto imm_srn = imm.create();
+    ASSERT_THROW(SrnGenerator(imm_srn, imm.marking()),
+                 std::invalid_argument);
+}
+
+TEST(petrinet, srn_kronecker_generator)
+{
+    // two submodels that return their tokens through one shared transition
+    SrnCreator ca;
+    auto a0 = ca.place(2);
+    auto a1 = ca.place();
+    ca.expTrans([=](PetriNetState st) {
+          return 1.0 * st.marking->nToken(a0);
+      })
+        .iarc(a0)
+        .oarc(a1);
+    auto ta_sync = ca.expTrans(1.0).iarc(a1).oarc(a0).idx();
+    auto srn_a = ca.create();
+    SrnCreator cb;
+    auto b0 = cb.place(1);
+    auto b1 = cb.place();
+    cb.expTrans(2.0).iarc(b0).oarc(b1);
+    auto tb_sync = cb.expTrans(1.0).iarc(b1).oarc(b0).idx();
+    auto srn_b = cb.create();
+    auto comp_a = srnKronComponent(srn_a, ca.marking(), {ta_sync});
+    auto comp_b = srnKronComponent(srn_b, cb.marking(), {tb_sync});
+    ASSERT_EQ(comp_a.markings.size(), 3);
+    ASSERT_EQ(comp_b.markings.size(), 2);
+    SrnKronGenerator gen({comp_a.localGenerator, comp_b.localGenerator});
+    gen.addSync(3.0,
+                {{0, comp_a.syncFactors[0]}, {1, comp_b.syncFactors[0]}});
+    uint n = gen.stateCount();
+    ASSERT_EQ(n, 6);
+
+    // the same model as one net
+    SrnCreator ct;
+    auto p_a0 = ct.place(2);
+    auto p_a1 = ct.place();
+    auto p_b0 = ct.place(1);
+    auto p_b1 = ct.place();
+    ct.expTrans([=](PetriNetState st) {
+          return 1.0 * st.marking->nToken(p_a0);
+      })
+        .iarc(p_a0)
+        .oarc(p_a1);
+    ct.expTrans(2.0).iarc(p_b0).oarc(p_b1);
+    ct.expTrans(3.0).iarc(p_a1).iarc(p_b1).oarc(p_a0).oarc(p_b0);
+    auto srn = ct.create();
+    auto rg = genReducedReachGraph(srn, ct.marking());
+    ASSERT_EQ(rg.graph.nodeCount(), n);
+    auto Q = srnRateMatrix(rg.graph, rg.edgeRates);
+    Vector ref(n, 1.0);
+    srnSteadyStateSor(Q, mutableView(ref), 1.0, 1e-12, 10000);
+
+    auto local_index = [](const SrnKronComponent& comp, uint t0, uint t1) {
+        for (uint i = 0; i < comp.markings.size(); i++)
+        {
+            if (comp.markings[i]->nToken(0) == t0 &&
+                comp.markings[i]->nToken(1) == t1)
+            {
+                return i;
+            }
+        }
+        return (uint)comp.markings.size();
+    };
+    std::vector<uint> kron_index(n);
+    for (uint i = 0; i < n; i++)
+    {
+        const auto* mk = rg.nodeMarkings[i].get();
+        uint ia = local_index(comp_a, mk->nToken(p_a0), mk->nToken(p_a1));
+        uint ib = local_index(comp_b, mk->nToken(p_b0), mk->nToken(p_b1));
+        kron_index[i] = ia * 2 + ib;
+    }
+
+    Vector power(n, 1.0);
+    auto power_res =
+        srnSteadyStatePower(gen, mutableView(power), 1e-13, 100000);
+    ASSERT_LT(power_res.error, 1e-13);
+    Vector jacobi(n, 1.0);
+    auto jacobi_res =
+        srnSteadyStateJacobi(gen, mutableView(jacobi), 0.8, 1e-13, 10000);
+    ASSERT_LT(jacobi_res.error, 1e-13);
+    for (uint i = 0; i < n; i++)
+    {
+        ASSERT_NEAR(power(kron_index[i]), ref(i), 1e-9);
+        ASSERT_NEAR(jacobi(kron_index[i]), ref(i), 1e-9);
+        ASSERT_NEAR(gen.diagonal()(kron_index[i]), SpmatrixGet(Q, i, i),
+                    1e-12);
+    }
+}
+
+TEST(petrinet, srn_sor_plan)
+{
+    SrnCreator ct;
+    auto p_live = ct.place(30);
+    auto p_dead = ct.place();
+    ct.expTrans(1.0).iarc(p_live).oarc(p_dead);
+    ct.expTrans(1.2).iarc(p_dead).oarc(p_live);
+    auto rg = genReducedReachGraph(ct.create(), ct.marking());
+    uint n = rg.graph.nodeCount();
+    auto Q = srnRateMatrix(rg.graph, rg.edgeRates);
+    Real tol = 1e-10;
+    auto plan = srnSorPlan(Q, tol);
+    ASSERT_GT(plan.w, 1.0);
+    Vector gs(n, 1.0);
+    auto gs_res = srnSteadyStateSor(Q, mutableView(gs), 1.0, tol, 100000);
+    Vector sor(n, 1.0);
+    auto sor_res =
+        srnSteadyStateSor(Q, mutableView(sor), plan.w, tol, 100000);
+    std::cout << "w: " << plan.w << ", rate: " << plan.rate
+              << ", predicted: " << plan.predictedIter
+              << ", sor nIter: " << sor_res.nIter
+              << ", gs nIter: " << gs_res.nIter << std::endl;
+    ASSERT_LT(sor_res.nIter, gs_res.nIter);
+    // the prediction is about the asymptotic rate, so within a factor of 2
+    ASSERT_LT(sor_res.nIter, 2 * plan.predictedIter);
+    ASSERT_LT(plan.predictedIter, 2 * sor_res.nIter);
+    for (uint i = 0; i < n; i++)
+    {
+        ASSERT_NEAR(sor(i), gs(i), 1e-8);
+    }
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "simulate.hpp"
+
+using namespace sanity::simulate;
+
+TEST(simulate_dsim, event_queue_order)
+{
+    EventQueueT<uint> queue;
+    queue.schedule(3.0, 0);
+    queue.schedule(1.0, 1);
+    queue.schedule(2.0, 2);
+    queue.schedule(1.0, 3);
+    queue.schedule(1.0, 4);
+    ASSERT_EQ(queue.size(), 5);
+    // ties are first in, first out
+    std::vector<uint> order;
+    while (queue.size() > 0)
+    {
+        order.push_back(queue.pop().data);
+    }
+    ASSERT_EQ(order, (std::vector<uint>{1, 3, 4, 2, 0}));
+}
+
+TEST(simulate_dsim, event_queue_cancel)
+{
+    EventQueueT<uint> queue;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<Real> dist(0.0, 100.0);
+    std::vector<EventHandle> handles;
+    std::vector<Real> times;
+    for (uint i = 0; i < 200; i++)
+    {
+        times.push_back(dist(gen));
+        handles.push_back(queue.schedule(times.back(), i));
+    }
+    // cancel every third event and move every fifth
+    std::vector<char> cancelled(200, 0);
+    for (uint i = 0; i < 200; i += 3)
+    {
+        EventQueueT<uint>::Event evt;
+        ASSERT_TRUE(queue.cancel(handles[i], &evt));
+        ASSERT_EQ(evt.data, i);
+        ASSERT_EQ(evt.time, times[i]);
+        ASSERT_FALSE(queue.cancel(handles[i]));
+        ASSERT_FALSE(queue.contains(handles[i]));
+        cancelled[i] = 1;
+    }
+    for (uint i = 1; i < 200; i += 5)
+    {
+        if (!cancelled[i])
+        {
+            times[i] = dist(gen);
+            auto h = queue.reschedule(handles[i], times[i]);
+            ASSERT_FALSE(queue.contains(handles[i]));
+            ASSERT_TRUE(queue.contains(h));
+            handles[i] = h;
+        }
+    }
+    // a reused slot does not revive an old handle
+    auto h = queue.schedule(50.0, 1000);
+    ASSERT_FALSE(queue.contains(handles[0]));
+    ASSERT_TRUE(queue.cancel(h));
+
+    auto pending = queue.events();
+    ASSERT_EQ(pending.size(), queue.size());
+    Real last = -1.0;
+    uint count = 0;
+    while (queue.size() > 0)
+    {
+        auto evt = queue.pop();
+        ASSERT_FALSE(cancelled[evt.data]);
+        ASSERT_EQ(evt.time, times[evt.data]);
+        ASSERT_EQ(evt.data, pending[count].data);
+        ASSERT_GE(evt.time, last);
+        last = evt.time;
+        count++;
+    }
+    ASSERT_EQ(count, 200 - 67);
+    for (const auto& handle : handles)
+    {
+        ASSERT_FALSE(queue.contains(handle));
+    }
+}
+
+TEST(simulate_dsim, event_queue_remove)
+{
+    EventQueueT<uint> queue;
+    for (uint i = 0; i < 10; i++)
+    {
+        queue.schedule(10.0 - i, i);
+    }
+    EventQueueT<uint>::Event evt;
+    ASSERT_TRUE(queue.removeFirst(
+        [](const EventQueueT<uint>::Event& e) { return e.data % 2 == 0; },
+        &evt));
+    // the even event that would fire last
+    ASSERT_EQ(evt.data, 0);
+    auto removed = queue.remove(
+        [](const EventQueueT<uint>::Event& e) { return e.data < 4; });
+    ASSERT_EQ(removed.size(), 3);
+    ASSERT_EQ(removed[0].data, 3);
+    ASSERT_EQ(removed[2].data, 1);
+    ASSERT_EQ(queue.size(), 6);
+    ASSERT_EQ(queue.peek().data, 9);
+}
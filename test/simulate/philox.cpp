@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "simulate.hpp"
+using namespace sanity::simulate;
+
+TEST(simulate, philox_known_answers)
+{
+    // test vectors of the Random123 reference implementation
+    auto r = philox4x32({0, 0, 0, 0}, {0, 0});
+    ASSERT_EQ(r, (PhiloxCounter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                0x9b00dbd8}));
+    r = philox4x32({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                   {0xffffffff, 0xffffffff});
+    ASSERT_EQ(r, (PhiloxCounter{0x408f276d, 0x41c83b0e, 0xa20bc7c6,
+                                0x6d5451fd}));
+    r = philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                   {0xa4093822, 0x299f31d0});
+    ASSERT_EQ(r, (PhiloxCounter{0xd16cfe09, 0x94fdcceb, 0x5001e420,
+                                0x24126ea1}));
+}
+
+TEST(simulate, philox_sampler)
+{
+    PhiloxSampler gen(42, 3);
+    std::vector<Real> seq(1001);
+    Real sum = 0;
+    for (auto& u : seq)
+    {
+        u = gen();
+        ASSERT_GT(u, 0.0);
+        ASSERT_LT(u, 1.0);
+        sum += u;
+    }
+    ASSERT_NEAR(sum / seq.size(), 0.5, 0.05);
+
+    // bulk generation and skipping give the same stream
+    PhiloxSampler bulk(42, 3);
+    std::vector<Real> head(3);
+    bulk.fill(head);
+    std::vector<Real> tail(998);
+    bulk.fill(tail);
+    head.insert(head.end(), tail.begin(), tail.end());
+    ASSERT_EQ(head, seq);
+
+    PhiloxSampler skip(42, 3);
+    skip.discard(501);
+    ASSERT_EQ(skip(), seq[501]);
+    ASSERT_EQ(skip(), seq[502]);
+
+    BufferedSampler buffered(42, 3, 16);
+    for (uint i = 0; i < seq.size(); i++)
+    {
+        ASSERT_EQ(buffered(), seq[i]);
+    }
+
+    // bulk blocks whose counter carries into the high word
+    PhiloxSampler one(42, 3);
+    PhiloxSampler many(42, 3);
+    one.discard(2 * 0xfffffffdull);
+    many.discard(2 * 0xfffffffdull);
+    std::vector<Real> carry(40);
+    many.fill(carry);
+    for (uint i = 0; i < carry.size(); i++)
+    {
+        ASSERT_EQ(carry[i], one());
+    }
+
+    // other streams and substreams
+    PhiloxSampler other(42, 4);
+    PhiloxSampler sub = gen.split(0);
+    ASSERT_NE(other(), seq[0]);
+    ASSERT_NE(sub(), seq[0]);
+    ASSERT_EQ(sub.seed(), (std::uint64_t)42);
+}
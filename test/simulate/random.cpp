@@ -28,3 +28,23 @@ TEST(simulate, confidence_interval)
     ASSERT_NEAR(itv.begin, 9.23 - 1.91, 0.01);
     ASSERT_NEAR(itv.end, 9.23 + 1.91, 0.01);
 }
+
+TEST(simulate, poisson_sample)
+{
+    PhiloxSampler uniform(5);
+    for (Real lambda : {0.0, 0.5, 4.0, 25.0, 1000.0})
+    {
+        uint n = 20000;
+        std::vector<Real> samples(n);
+        for (auto& x : samples)
+        {
+            x = poissonSample(lambda, uniform);
+        }
+        Real m = mean(samples);
+        Real var = sampleVariance(samples, m);
+        std::cout << "lambda " << lambda << ": mean " << m << ", variance "
+                  << var << std::endl;
+        ASSERT_NEAR(m, lambda, 4 * std::sqrt(lambda / n) + 1e-12);
+        ASSERT_NEAR(var, lambda, 0.05 * lambda + 1e-12);
+    }
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "simulate.hpp"
+using namespace sanity::simulate;
+
+TEST(simulate, online_stats)
+{
+    UniformSampler uniform(3);
+    std::vector<Real> samples;
+    OnlineStats all, first, second;
+    for (uint i = 0; i < 1000; i++)
+    {
+        Real x = 1e6 + uniform();
+        samples.push_back(x);
+        all.add(x);
+        (i < 300 ? first : second).add(x);
+    }
+    Real mu = mean(samples);
+    ASSERT_EQ(all.count(), 1000);
+    ASSERT_NEAR(all.mean(), mu, 1e-6);
+    ASSERT_NEAR(all.sampleVariance(), sampleVariance(samples, mu), 1e-6);
+    ASSERT_EQ(all.min(), *std::min_element(samples.begin(), samples.end()));
+
+    first.merge(second);
+    ASSERT_EQ(first.count(), 1000);
+    ASSERT_NEAR(first.mean(), all.mean(), 1e-6);
+    ASSERT_NEAR(first.variance(), all.variance(), 1e-6);
+    ASSERT_EQ(first.max(), all.max());
+
+    auto itv = confidenceInterval(all, 0.95);
+    auto expected = confidenceInterval(samples, 0.95);
+    ASSERT_NEAR(itv.begin, expected.begin, 1e-6);
+    ASSERT_NEAR(itv.end, expected.end, 1e-6);
+    ASSERT_THROW(confidenceInterval(OnlineStats(), 0.95),
+                 std::invalid_argument);
+    ASSERT_TRUE(std::isinf(relativeHalfWidth(OnlineStats(), 0.95)));
+}
+
+TEST(simulate, quantile_sketch)
+{
+    UniformSampler uniform(5);
+    QuantileSketch sketch(128);
+    QuantileSketch part1(128), part2(128);
+    for (uint i = 0; i < 100000; i++)
+    {
+        Real x = uniform();
+        sketch.add(x);
+        (i % 3 == 0 ? part1 : part2).add(x);
+    }
+    part1.merge(part2);
+    ASSERT_EQ(sketch.count(), 100000);
+    ASSERT_EQ(part1.count(), 100000);
+    for (Real q : {0.01, 0.1, 0.5, 0.9, 0.99})
+    {
+        ASSERT_NEAR(sketch.quantile(q), q, 0.02);
+        ASSERT_NEAR(part1.quantile(q), q, 0.02);
+    }
+
+    QuantileSketch small;
+    for (Real x : {3.0, 1.0, 2.0})
+    {
+        small.add(x);
+    }
+    ASSERT_EQ(small.quantile(0.0), 1.0);
+    ASSERT_EQ(small.quantile(0.5), 2.0);
+    ASSERT_EQ(small.quantile(1.0), 3.0);
+    ASSERT_THROW(QuantileSketch().quantile(0.5), std::invalid_argument);
+}
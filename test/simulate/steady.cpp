@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include "simulate.hpp"
+using namespace sanity::simulate;
+
+TEST(simulate, mser5_truncation)
+{
+    // a decaying transient followed by a stationary sequence
+    UniformSampler uniform(7);
+    std::vector<Real> obs;
+    for (uint i = 0; i < 1000; i++)
+    {
+        obs.push_back(10.0 * std::exp(-0.05 * i) + uniform());
+    }
+    uint d = mser5Truncation(obs);
+    ASSERT_EQ(d % 5, 0);
+    ASSERT_GE(d, 60);
+    ASSERT_LE(d, 200);
+
+    std::vector<Real> flat;
+    for (uint i = 0; i < 1000; i++)
+    {
+        flat.push_back(uniform());
+    }
+    // nothing to cut off from a stationary sequence
+    ASSERT_LE(mser5Truncation(flat), 50);
+    ASSERT_EQ(mser5Truncation({1.0, 2.0, 3.0}), 0);
+}
+
+TEST(simulate, batch_means)
+{
+    std::vector<Real> obs{9, 1, 2, 3, 4, 5, 6, 7};
+    // 7 observations after the first: the leading one is dropped
+    ASSERT_EQ(batchMeans(obs, 1, 3), std::vector<Real>({2.5, 4.5, 6.5}));
+    ASSERT_EQ(batchMeans(obs, 6, 3), std::vector<Real>({6, 7}));
+    ASSERT_TRUE(batchMeans(obs, 8, 3).empty());
+}
@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "simulate.hpp"
+using namespace sanity::simulate;
+
+TEST(simulate, sum_tree)
+{
+    SumTree tree(5);
+    ASSERT_EQ(tree.total(), 0.0);
+    tree.set(0, 1.0);
+    tree.set(2, 2.0);
+    tree.set(4, 0.5);
+    ASSERT_EQ(tree.total(), 3.5);
+    ASSERT_EQ(tree.weight(2), 2.0);
+    ASSERT_EQ(tree.find(0.0), 0);
+    ASSERT_EQ(tree.find(0.99), 0);
+    ASSERT_EQ(tree.find(1.0), 2);
+    ASSERT_EQ(tree.find(2.99), 2);
+    ASSERT_EQ(tree.find(3.0), 4);
+    // rounding past the total still finds the last positive weight
+    ASSERT_EQ(tree.find(3.5), 4);
+
+    tree.set(4, 0.0);
+    ASSERT_EQ(tree.total(), 3.0);
+    ASSERT_EQ(tree.find(3.2), 2);
+
+    tree.clear();
+    ASSERT_EQ(tree.total(), 0.0);
+    tree.set(3, 4.0);
+    ASSERT_EQ(tree.find(0.0), 3);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "linear.hpp"
+#include "splinear.hpp"
+
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+// tridiagonal, diagonally dominant for every parameter point
+static SpmatrixPattern tridiagPattern(uint n, const std::vector<Real>& params)
+{
+    SpmatrixPatternCreator crt(n, n, 2);
+    for (uint i = 0; i < n; i++)
+    {
+        crt.addConstant(i, i, 4.0);
+        crt.addEntry(i, i, 0, 1.0);
+        if (i > 0)
+        {
+            crt.addEntry(i, i - 1, 1, -1.0);
+        }
+        if (i + 1 < n)
+        {
+            crt.addEntry(i, i + 1, 0, -1.0);
+        }
+    }
+    return crt.create(Spmatrix::RowCompressed, params);
+}
+
+TEST(splinear_batch, dot)
+{
+    uint n = 50;
+    std::vector<std::vector<Real>> params = {
+        {0.5, 1.0}, {1.0, 2.0}, {2.0, 0.1}};
+    auto pat = tridiagPattern(n, params[0]);
+    auto batch = spmatrixBatch(pat, params);
+    uint K = params.size();
+    Matrix V(n, K);
+    for (uint i = 0; i < n; i++)
+    {
+        for (uint lane = 0; lane < K; lane++)
+        {
+            V(i, lane) = (Real)(i + lane);
+        }
+    }
+    Matrix X(n, K);
+    dot(batch, constView(V), mutableView(X));
+    for (uint lane = 0; lane < K; lane++)
+    {
+        updateValues(pat, params[lane]);
+        Vector v(n);
+        Vector x(n);
+        for (uint i = 0; i < n; i++)
+        {
+            v(i) = V(i, lane);
+        }
+        dot(pat.matrix, v, mutableView(x));
+        for (uint i = 0; i < n; i++)
+        {
+            ASSERT_NEAR(X(i, lane), x(i), 1e-12);
+        }
+    }
+}
+
+TEST(splinear_batch, sor)
+{
+    uint n = 50;
+    std::vector<std::vector<Real>> params = {
+        {0.5, 1.0}, {1.0, 2.0}, {2.0, 0.1}};
+    auto pat = tridiagPattern(n, params[0]);
+    uint K = params.size();
+    Matrix B(n, K);
+    for (uint i = 0; i < n; i++)
+    {
+        for (uint lane = 0; lane < K; lane++)
+        {
+            B(i, lane) = 1.0 + (Real)lane;
+        }
+    }
+    // one matrix per lane
+    Matrix X(n, K, 0.0);
+    auto res = solveSorBatch(spmatrixBatch(pat, params), mutableView(X),
+                             constView(B), 1.0, 1e-12, 1000);
+    // one shared matrix, several right hand sides
+    updateValues(pat, params[1]);
+    Matrix Xs(n, K, 0.0);
+    auto res_shared = solveSorBatch(spmatrixBatch(pat.matrix),
+                                    mutableView(Xs), constView(B), 1.0,
+                                    1e-12, 1000);
+    for (uint lane = 0; lane < K; lane++)
+    {
+        ASSERT_LT(res[lane].error, 1e-12);
+        ASSERT_LT(res_shared[lane].error, 1e-12);
+        updateValues(pat, params[lane]);
+        Vector x(n, 0.0);
+        Vector b(n, 1.0 + (Real)lane);
+        auto ref = solveSor(pat.matrix, mutableView(x), b, 1.0, 1e-12, 1000);
+        // a lane converges exactly as it does on its own
+        ASSERT_EQ(res[lane].nIter, ref.nIter);
+        for (uint i = 0; i < n; i++)
+        {
+            ASSERT_EQ(X(i, lane), x(i));
+        }
+    }
+    // linear in the right hand side
+    for (uint i = 0; i < n; i++)
+    {
+        ASSERT_NEAR(Xs(i, 2), 3.0 * Xs(i, 0), 1e-10);
+    }
+}
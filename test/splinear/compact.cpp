@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "linear.hpp"
+#include "splinear.hpp"
+
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+// a diagonal dominant matrix with a few columns far away from the diagonal
+static Spmatrix farColumnMatrix(uint n, Spmatrix::Format format)
+{
+    SpmatrixCreator crt(n, n);
+    for (uint i = 0; i < n; i++)
+    {
+        crt.addEntry(i, i, 4.0);
+        crt.addEntry(i, (i + 1) % n, -1.0);
+        if (i % 10 == 0)
+        {
+            crt.addEntry(i, (i + 70000) % n, -0.5);
+            crt.addEntry(i, (i + 65535) % n, -0.5);
+        }
+    }
+    return crt.create(format);
+}
+
+TEST(splinear_compact, dot)
+{
+    uint n = 100000;
+    for (auto format : {Spmatrix::RowCompressed, Spmatrix::ColCompressed})
+    {
+        auto A = farColumnMatrix(n, format);
+        auto C = spmatrix2compact(A);
+        ASSERT_GT(C.nfar, 0);
+        ASSERT_EQ(C.delta.size(), A.idx.size() + 2 * C.nfar);
+        ASSERT_EQ(C.val.size(), C.delta.size());
+        Vector v(n);
+        for (uint i = 0; i < n; i++)
+        {
+            v(i) = (Real)(i % 17);
+        }
+        Vector x1(n, 1.0);
+        Vector x2(n, 1.0);
+        dotpx(A, v, mutableView(x1));
+        dotpx(C, v, mutableView(x2));
+        ASSERT_EQ(maxDiff(x1, x2), 0.0);
+        dot(A, v, mutableView(x1));
+        dot(C, v, mutableView(x2));
+        ASSERT_EQ(maxDiff(x1, x2), 0.0);
+    }
+}
+
+TEST(splinear_compact, sor)
+{
+    uint n = 100000;
+    auto A = farColumnMatrix(n, Spmatrix::RowCompressed);
+    auto C = spmatrix2compact(A);
+    Vector b(n, 1.0);
+    Vector x1(n, 0.0);
+    Vector x2(n, 0.0);
+    auto res1 = solveSor(A, mutableView(x1), b, 1.0, 1e-10, 100);
+    auto res2 = solveSor(C, mutableView(x2), b, 1.0, 1e-10, 100);
+    ASSERT_EQ(res1.nIter, res2.nIter);
+    ASSERT_EQ(maxDiff(x1, x2), 0.0);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "linear.hpp"
+#include "splinear.hpp"
+
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+// generator of a birth-death chain with n states, birth rate a and death
+// rate b, in the layout Q(dst, src)
+static Spmatrix birthDeath(uint n, Real a, Real b)
+{
+    SpmatrixCreator crt(n, n);
+    for (uint i = 0; i < n; i++)
+    {
+        if (i + 1 < n)
+        {
+            crt.addEntry(i + 1, i, a);
+            crt.addEntry(i, i, -a);
+            crt.addEntry(i, i + 1, b);
+            crt.addEntry(i + 1, i + 1, -b);
+        }
+    }
+    return crt.create(Spmatrix::RowCompressed);
+}
+
+TEST(splinear_eigen, arnoldi_diagonal)
+{
+    uint n = 40;
+    auto op = [](VectorConstView v, VectorMutableView x) {
+        for (uint i = 0; i < v.size(); i++)
+        {
+            x(i) = (1.0 + i) * v(i);
+        }
+    };
+    // the Krylov space of a vector with 5 nonzeros is invariant
+    Vector v0(n, 0.0);
+    for (uint i = 0; i < 5; i++)
+    {
+        v0(i * 8) = 1.0;
+    }
+    auto eigs = arnoldiEigenvalues(op, v0, 20);
+    ASSERT_EQ(eigs.size(), 5);
+    for (uint i = 0; i < 5; i++)
+    {
+        ASSERT_NEAR(eigs[i].real(), 1.0 + (4 - i) * 8, 1e-10);
+    }
+}
+
+TEST(splinear_eigen, subdominant_birthdeath)
+{
+    uint n = 20;
+    Real a = 1.0;
+    Real b = 4.0;
+    auto Q = birthDeath(n, a, b);
+    // uniformized P = I + Q / q
+    Real q = 6.0;
+    auto P = Q;
+    for (uint i = 0; i < n; i++)
+    {
+        for (uint k = P.ptr[i]; k < P.ptr[i + 1]; k++)
+        {
+            P.val[k] = P.val[k] / q + (P.idx[k] == i ? 1.0 : 0.0);
+        }
+    }
+    // eigenvalues of Q are 0 and -(a + b) + 2 sqrt(ab) cos(k pi / n)
+    Real lambda2 =
+        1.0 + (-(a + b) + 2.0 * std::sqrt(a * b) * std::cos(M_PI / n)) / q;
+    auto sub = subdominantEigenvalue(P, 30);
+    ASSERT_NEAR(sub.real(), lambda2, 1e-8);
+    ASSERT_NEAR(sub.imag(), 0.0, 1e-8);
+
+    // birth-death chains are consistently ordered, so Young's w is optimal
+    Real w = sorOptimalRelaxation(Q);
+    ASSERT_GT(w, 1.0);
+    ASSERT_LT(w, 2.0);
+    Real gs_rate = sorConvergenceRate(Q, 1.0);
+    Real rate = sorConvergenceRate(Q, w);
+    ASSERT_LT(rate, gs_rate);
+    ASSERT_LT(rate, sorConvergenceRate(Q, w - 0.1));
+    ASSERT_LT(rate, sorConvergenceRate(Q, w + 0.1) + 1e-6);
+}
+
+TEST(splinear_eigen, predict_iterations)
+{
+    ASSERT_EQ(predictIterations(0.5, 1.0 / 1024), 10);
+    ASSERT_EQ(predictIterations(0.1, 1e-6, 1e-2), 4);
+    ASSERT_EQ(predictIterations(1.0, 1e-6), std::numeric_limits<uint>::max());
+    ASSERT_EQ(predictIterations(0.0, 1e-6), 1);
+}
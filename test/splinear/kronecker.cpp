@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "linear.hpp"
+#include "splinear.hpp"
+
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+static Spmatrix smallMatrix(uint n, Real seed)
+{
+    SpmatrixCreator crt(n, n);
+    for (uint i = 0; i < n; i++)
+    {
+        crt.addEntry(i, i, seed + i);
+        crt.addEntry(i, (i + 1) % n, -seed * (i + 1));
+        if (i % 2 == 0)
+        {
+            crt.addEntry((i + 2) % n, i, 0.5 * seed);
+        }
+    }
+    return crt.create(Spmatrix::RowCompressed);
+}
+
+// dense entry of A_1 x ... x A_N at (row, col)
+static Real kronEntry(const std::vector<const Spmatrix*>& mats,
+                      const std::vector<uint>& sizes, uint row, uint col)
+{
+    Real val = 1.0;
+    for (uint c = sizes.size(); c-- > 0;)
+    {
+        uint i = row % sizes[c];
+        uint j = col % sizes[c];
+        row /= sizes[c];
+        col /= sizes[c];
+        val *= mats[c] ? SpmatrixGet(*mats[c], i, j) : (i == j ? 1.0 : 0.0);
+    }
+    return val;
+}
+
+TEST(splinear_kronecker, dot)
+{
+    std::vector<uint> sizes = {3, 4, 2};
+    auto A0 = smallMatrix(3, 1.0);
+    auto A1 = smallMatrix(4, 2.0);
+    auto A2 = smallMatrix(2, 0.5);
+    auto B1 = smallMatrix(4, -1.0);
+    KronDescriptor D(sizes);
+    D.addLocal(0, A0);
+    D.addLocal(2, A2);
+    D.addProduct(0.7, {{2, A2}, {1, A1}});
+    D.addProduct(-1.5, {{0, A0}, {1, B1}, {2, A2}});
+    ASSERT_EQ(D.size(), 24);
+    ASSERT_THROW(D.addProduct(1.0, {{1, A0}}), std::invalid_argument);
+    ASSERT_THROW(D.addProduct(1.0, {{0, A0}, {0, A0}}),
+                 std::invalid_argument);
+
+    uint N = D.size();
+    Matrix dense(N, N, 0.0);
+    for (uint row = 0; row < N; row++)
+    {
+        for (uint col = 0; col < N; col++)
+        {
+            dense(row, col) =
+                kronEntry({&A0, nullptr, nullptr}, sizes, row, col) +
+                kronEntry({nullptr, nullptr, &A2}, sizes, row, col) +
+                0.7 * kronEntry({nullptr, &A1, &A2}, sizes, row, col) -
+                1.5 * kronEntry({&A0, &B1, &A2}, sizes, row, col);
+        }
+    }
+    Vector v(N);
+    for (uint i = 0; i < N; i++)
+    {
+        v(i) = 1.0 + 0.1 * i;
+    }
+    Vector x(N);
+    dot(D, v, mutableView(x));
+    auto d = diagonal(D);
+    for (uint row = 0; row < N; row++)
+    {
+        Real ref = 0.0;
+        for (uint col = 0; col < N; col++)
+        {
+            ref += dense(row, col) * v(col);
+        }
+        ASSERT_NEAR(x(row), ref, 1e-12);
+        ASSERT_NEAR(d(row), dense(row, row), 1e-12);
+    }
+}
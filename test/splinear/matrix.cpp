@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <utility>
+#include "simulate.hpp"
+#include "splinear.hpp"
+
+using namespace sanity::splinear;
+using namespace sanity::simulate;
+
+TEST(splinear_matrix, triple2compressed)
+{
+    uint nrow = 300;
+    uint ncol = 200;
+    UniformSampler sampler(7);
+    for (uint nthread : {1u, 3u})
+    {
+        for (auto format : {Spmatrix::RowCompressed, Spmatrix::ColCompressed})
+        {
+            SpmatrixCreator crt(nrow, ncol);
+            std::map<std::pair<uint, uint>, Real> ref;
+            for (uint k = 0; k < 5000; k++)
+            {
+                auto i = (uint)(sampler() * nrow);
+                auto j = (uint)(sampler() * ncol);
+                Real v = sampler();
+                crt.addEntry(i, j, v);
+                ref[{i, j}] += v;
+                if (k % 7 == 0)
+                {  // duplicates cancelling each other
+                    crt.addEntry(i, j, -ref[{i, j}]);
+                    ref.erase({i, j});
+                }
+            }
+            auto A = crt.create(format, nthread);
+            ASSERT_EQ(A.val.size(), ref.size());
+            uint nmajor = format == Spmatrix::RowCompressed ? nrow : ncol;
+            ASSERT_EQ(A.ptr.size(), nmajor + 1);
+            for (uint i = 0; i < nmajor; i++)
+            {
+                for (uint k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+                {
+                    if (k > A.ptr[i])
+                    {
+                        ASSERT_LT(A.idx[k - 1], A.idx[k]);
+                    }
+                    auto key = format == Spmatrix::RowCompressed
+                                   ? std::make_pair(i, A.idx[k])
+                                   : std::make_pair(A.idx[k], i);
+                    ASSERT_NEAR(A.val[k], ref.at(key), 1e-12);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include "linear.hpp"
+#include "splinear.hpp"
+
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+TEST(splinear_mixed, sor_refinement)
+{
+    uint n = 50;
+    SpmatrixCreator crt(n, n);
+    for (uint i = 0; i < n; i++)
+    {
+        crt.addEntry(i, i, 4.0 + 1.0 / 3.0);
+        if (i > 0)
+        {
+            crt.addEntry(i, i - 1, -1.0 / 7.0);
+        }
+        if (i + 1 < n)
+        {
+            crt.addEntry(i, i + 1, -1.1);
+        }
+    }
+    auto A = crt.create(Spmatrix::RowCompressed);
+    Vector b(n);
+    for (uint i = 0; i < n; i++)
+    {
+        b(i) = std::sin((Real)i);
+    }
+    Vector x(n, 0.0);
+    auto res = solveSorMixed(A, mutableView(x), b, 1.0, 1e-13, 1000);
+    ASSERT_LT(res.error, 1e-13);
+
+    // the residual is at double precision level, beyond float accuracy
+    Vector Ax(n);
+    dot(A, x, mutableView(Ax));
+    ASSERT_LT(maxDiff(Ax, b), 1e-11);
+}
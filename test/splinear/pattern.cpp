@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "linear.hpp"
+#include "splinear.hpp"
+
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+// a random sparse matrix, with duplicates and a constant entry per row
+static void fillCreators(uint n, uint nkey, SpmatrixPatternCreator& pcrt,
+                         SpmatrixCreator& crt,
+                         const std::vector<Real>& params)
+{
+    for (uint i = 0; i < n; i++)
+    {
+        for (uint k = 0; k < 4; k++)
+        {
+            uint j = (i * 7 + k * 13) % n;
+            uint key = (i + k) % nkey;
+            Real coef = (k % 2 == 0) ? 1.0 : -0.5;
+            pcrt.addEntry(i, j, key, coef);
+            crt.addEntry(i, j, coef * params[key]);
+            pcrt.addEntry(i, i, key, -coef);
+            crt.addEntry(i, i, -coef * params[key]);
+        }
+        pcrt.addConstant(i, n - 1 - i, 2.0);
+        crt.addEntry(i, n - 1 - i, 2.0);
+    }
+}
+
+static void assertSameMatrix(const Spmatrix& A, const Spmatrix& B)
+{
+    ASSERT_EQ(A.nrow, B.nrow);
+    ASSERT_EQ(A.ncol, B.ncol);
+    for (uint i = 0; i < A.nrow; i++)
+    {
+        for (uint j = 0; j < A.ncol; j++)
+        {
+            ASSERT_NEAR(SpmatrixGet(A, i, j), SpmatrixGet(B, i, j), 1e-12);
+        }
+    }
+}
+
+TEST(splinear_pattern, update)
+{
+    uint n = 50;
+    uint nkey = 17;
+    for (auto format : {Spmatrix::RowCompressed, Spmatrix::ColCompressed})
+    {
+        std::vector<Real> params(nkey);
+        for (uint i = 0; i < nkey; i++)
+        {
+            params[i] = 1.0 + i;
+        }
+        SpmatrixPatternCreator pcrt(n, n, nkey);
+        SpmatrixCreator crt(n, n);
+        fillCreators(n, nkey, pcrt, crt, params);
+        auto pat = pcrt.create(format, params);
+        ASSERT_EQ(pat.matrix.format, format);
+        assertSameMatrix(pat.matrix, crt.create(format));
+
+        for (uint i = 0; i < nkey; i++)
+        {
+            params[i] = 0.1 * (Real)(i * i);
+        }
+        updateValues(pat, params);
+        SpmatrixCreator crt2(n, n);
+        SpmatrixPatternCreator unused(n, n, nkey);
+        fillCreators(n, nkey, unused, crt2, params);
+        assertSameMatrix(pat.matrix, crt2.create(format));
+    }
+}
+
+TEST(splinear_pattern, keep_zeros)
+{
+    SpmatrixPatternCreator pcrt(2, 2, 1);
+    pcrt.addEntry(0, 1, 0, 1.0);
+    pcrt.addEntry(1, 1, 0, -1.0);
+    pcrt.addConstant(1, 0, 3.0);
+    auto pat = pcrt.create(Spmatrix::RowCompressed, {0.0});
+    ASSERT_EQ(pat.matrix.val.size(), 3);
+    ASSERT_EQ(SpmatrixGet(pat.matrix, 0, 1), 0.0);
+    updateValues(pat, {2.0});
+    ASSERT_EQ(SpmatrixGet(pat.matrix, 0, 1), 2.0);
+    ASSERT_EQ(SpmatrixGet(pat.matrix, 1, 1), -2.0);
+    ASSERT_EQ(SpmatrixGet(pat.matrix, 1, 0), 3.0);
+}
+
+TEST(splinear_pattern, unused_keys)
+{
+    uint nkey = 1000000;
+    SpmatrixPatternCreator pcrt(2, 2, nkey);
+    pcrt.addEntry(0, 1, 500000, 1.0);
+    pcrt.addEntry(1, 1, 500000, -1.0);
+    pcrt.addEntry(1, 0, 7, 2.0);
+    std::vector<Real> params(nkey, 0.0);
+    auto pat = pcrt.create(Spmatrix::RowCompressed, params);
+    ASSERT_EQ(pat.valueMap.keys, std::vector<uint>({7, 500000}));
+    ASSERT_EQ(pat.valueMap.keyPtr.size(), 3);
+    ASSERT_EQ(pat.valueMap.pos.size(), 3);
+    params[7] = 1.5;
+    params[500000] = 3.0;
+    updateValues(pat, params);
+    ASSERT_EQ(SpmatrixGet(pat.matrix, 0, 1), 3.0);
+    ASSERT_EQ(SpmatrixGet(pat.matrix, 1, 1), -3.0);
+    ASSERT_EQ(SpmatrixGet(pat.matrix, 1, 0), 3.0);
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "linear.hpp"
+#include "splinear.hpp"
+
+using namespace sanity::splinear;
+using namespace sanity::linear;
+
+static Spmatrix irregularMatrix(uint n)
+{
+    SpmatrixCreator crt(n, n);
+    for (uint i = 0; i < n; i++)
+    {
+        crt.addEntry(i, i, -1.0 - i);
+        for (uint k = 1; k <= i % 7; k++)
+        {
+            crt.addEntry(i, (i * 13 + k * 5) % n, 0.5 * k);
+        }
+    }
+    return crt.create(Spmatrix::RowCompressed);
+}
+
+TEST(splinear_sell, dot_matches_csr)
+{
+    uint n = 101;
+    auto A = irregularMatrix(n);
+    Vector v(n);
+    for (uint i = 0; i < n; i++)
+    {
+        v(i) = 1.0 / (1.0 + i);
+    }
+    Vector expected(n);
+    dot(A, v, mutableView(expected));
+    for (uint chunk : {1u, 4u, 8u, 16u})
+    {
+        for (uint sigma : {1u, 32u, 1000u})
+        {
+            auto sell = spmatrix2sell(A, chunk, sigma);
+            for (auto kernel :
+                 {SellKernel::Scalar, SellKernel::Avx2, SellKernel::Avx512})
+            {
+                Vector x(n, -1.0);
+                dot(sell, v, mutableView(x), kernel);
+                ASSERT_LT(maxDiff(x, expected), 1e-12);
+            }
+        }
+    }
+}
+
+TEST(splinear_sell, empty_rows)
+{
+    SpmatrixCreator crt(5, 3);
+    crt.addEntry(3, 2, 2.0);
+    auto sell = spmatrix2sell(crt.create(Spmatrix::RowCompressed), 4);
+    Vector v(3, 1.0);
+    Vector x(5, -1.0);
+    dot(sell, v, mutableView(x));
+    ASSERT_EQ(x(0), 0.0);
+    ASSERT_EQ(x(3), 2.0);
+    ASSERT_EQ(x(4), 0.0);
+}